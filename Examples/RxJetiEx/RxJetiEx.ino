@@ -72,6 +72,7 @@ void loop()
     }
   }
   // delay( 10 ); <-- don't put a delay here, because you will get buffer overruns 
+  //                   (AVR: check jetiDecode.GetSerial()->GetOverflows() and increase RXJETIEX_RX_RINGBUF_SIZE)
 }
 
 void PrintName( RxJetiExPacketName * pName )
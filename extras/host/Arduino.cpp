@@ -0,0 +1,35 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  Arduino.cpp - time base for host (Linux/POSIX) builds
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include "Arduino.h"
+#include <time.h>
+
+static uint64_t MonotonicMicros()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t s_tiStart = MonotonicMicros();
+
+// both wrap around like on Arduino
+uint32_t millis( void )
+{
+  return (uint32_t)( ( MonotonicMicros() - s_tiStart ) / 1000 );
+}
+
+uint32_t micros( void )
+{
+  return (uint32_t)( MonotonicMicros() - s_tiStart );
+}
@@ -0,0 +1,33 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  Arduino.h - minimal Arduino shim for host (Linux/POSIX) builds
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#ifndef RXJETIEX_HOST_ARDUINO_H
+#define RXJETIEX_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifndef min
+  #define min(a,b) ((a)<(b)?(a):(b))
+#endif
+#ifndef max
+  #define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+uint32_t millis( void );
+uint32_t micros( void );
+
+#endif // RXJETIEX_HOST_ARDUINO_H
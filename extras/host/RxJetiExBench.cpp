@@ -0,0 +1,355 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExBench - host benchmark suite over the capture corpus in extras/corpus:
+                  decoder throughput (Feed and GetPacket), cost per stage (crc, decrypt,
+                  value decode, label lookup) and label lookup cost by dictionary size
+                     
+                  usage: RxJetiExBench [-j] [corpus files]  (extras/corpus/<name>.jx9 if omitted)
+                         -j  JSON lines for scripts, one measurement per line
+
+                  The corpus is synthetic, written by RxJetiExGen:
+                    basic.jx9  -n 150 -s 4 -v 6
+                    crypt.jx9  -n 150 -s 4 -v 6 -k 0x5A
+                    noisy.jx9  -n 150 -s 4 -v 6 -e 0.02 -d 0.002 -r 7
+                    many.jx9   -n 48 -s 16 -v 15 -r 3
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include "RxJetiExDecodeT.h"
+#include "RxJetiExEncode.h"
+
+#ifndef RXJETIEX_CORPUS_DIR
+  #define RXJETIEX_CORPUS_DIR "extras/corpus"
+#endif
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// repeat until 100 ms are spent, returns ns per call
+template< class FN >
+static double Measure( FN fn )
+{
+  uint64_t nCalls  = 0;
+  uint64_t tiStart = NanoTime();
+  uint64_t tiElapsed;
+  do
+  {
+    fn();
+    nCalls++;
+  } while( ( tiElapsed = NanoTime() - tiStart ) < 100000000ULL );
+  return (double)tiElapsed / nCalls;
+}
+
+static bool s_bJson = false;
+
+static void Report( const char * pCorpus, const char * pMetric, double value, const char * pUnit )
+{
+  if( s_bJson )
+    printf( "{\"corpus\":\"%s\",\"metric\":\"%s\",\"value\":%.3f,\"unit\":\"%s\"}\n", pCorpus, pMetric, value, pUnit );
+  else
+    printf( "%-10s %-22s %14.2f %s\n", pCorpus, pMetric, value, pUnit );
+}
+
+// port and decoder with access to the stages
+struct NullPort
+{
+  void     Init(){}
+  size_t   Read( uint16_t * /* pDst */, size_t /* nMax */ ){ return 0; }
+  uint16_t GetOverflows(){ return 0; }
+  uint8_t  GetHighWater(){ return 0; }
+};
+
+struct MemoryPort
+{
+  void     Init(){}
+  size_t   Read( uint16_t * pDst, size_t nMax )
+  {
+    size_t n = m_nWords - m_idx < nMax ? m_nWords - m_idx : nMax;
+    memcpy( pDst, &m_pWords[ m_idx ], n * sizeof( uint16_t ) );
+    m_idx += n;
+    return n;
+  }
+  uint16_t GetOverflows(){ return 0; }
+  uint8_t  GetHighWater(){ return 0; }
+
+  const uint16_t * m_pWords;
+  size_t           m_nWords;
+  size_t           m_idx;
+};
+
+class BenchDecode : public RxJetiDecodeT< NullPort, 64, 255 >
+{
+public:
+  // values of a decrypted EX data frame, including the label lookup per value
+  uint8_t DecodeFrame( const uint8_t * pBody, uint8_t nPacketLen )
+  {
+    memcpy( m_exBuffer, pBody, nPacketLen );
+    m_nPacketLen = nPacketLen;
+    BeginValues();
+    uint8_t n = 0;
+    while( DecodeValue() )
+      n++;
+    return n;
+  }
+  RxJetiExPacketLabel * Lookup( uint32_t serialId, uint8_t id ){ return FindLabel( serialId, id ); }
+};
+
+// EX frame as received: length byte, body incl. key, crc
+struct Frame
+{
+  uint8_t lenByte;
+  uint8_t body[ 32 ];
+};
+
+struct Key
+{
+  uint32_t serialId;
+  uint8_t  id;
+};
+
+static uint16_t * Load( const char * pPath, size_t * pnWords )
+{
+  FILE * fp = fopen( pPath, "rb" );
+  if( fp == NULL )
+    return NULL;
+  fseek( fp, 0, SEEK_END );
+  long size = ftell( fp );
+  fseek( fp, 0, SEEK_SET );
+  uint16_t * pWords = (uint16_t *)malloc( size + 2 );
+  *pnWords = fread( pWords, sizeof( uint16_t ), size / 2, fp );
+  fclose( fp );
+  return pWords;
+}
+
+static void BenchCorpus( const char * pPath )
+{
+  size_t     nWords;
+  uint16_t * pWords = Load( pPath, &nWords );
+  if( pWords == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    return;
+  }
+  char name[ 64 ];
+  const char * pBase = strrchr( pPath, '/' ) ? strrchr( pPath, '/' ) + 1 : pPath;
+  snprintf( name, sizeof( name ), "%s", pBase );
+  if( strchr( name, '.' ) )
+    *strchr( name, '.' ) = '\0';
+
+  // frames: start markers, EX frames with complete body
+  size_t  nFrames = 0, nEx = 0;
+  Frame * pFrames = (Frame *)malloc( ( nWords / 4 + 1 ) * sizeof( Frame ) );
+  for( size_t i = 0; i < nWords; i++ )
+  {
+    if( pWords[ i ] == 0x00FE || pWords[ i ] == 0x007E )
+      nFrames++;
+    if( pWords[ i ] == 0x007E && i + 2 < nWords && ( pWords[ i + 1 ] & 0x0F ) == 0x0F )
+    {
+      uint8_t len = pWords[ i + 2 ] & 0x1F;
+      if( len > 5 && i + 3 + len <= nWords )
+      {
+        pFrames[ nEx ].lenByte = (uint8_t)pWords[ i + 2 ];
+        for( uint8_t j = 0; j < len; j++ )
+          pFrames[ nEx ].body[ j ] = (uint8_t)pWords[ i + 3 + j ];
+        nEx++;
+      }
+    }
+  }
+
+  // throughput, push and pull
+  static BenchDecode feedDecode;
+  size_t nPackets = 0;
+  double tiFeed = Measure( [&](){ feedDecode.ResetDictionary(); feedDecode.ResetState(); nPackets = feedDecode.Feed( pWords, nWords ); } );
+
+  static RxJetiDecodeT< MemoryPort, 64, 255 > pollDecode;
+  double tiPoll = Measure( [&]()
+  {
+    pollDecode.ResetDictionary();
+    pollDecode.ResetState();
+    MemoryPort & port = pollDecode.GetSerial();
+    port.m_pWords = pWords;
+    port.m_nWords = nWords;
+    port.m_idx    = 0;
+    while( pollDecode.GetPacket() || port.m_idx < port.m_nWords )
+      ;
+  } );
+
+  Report( name, "words", nWords, "" );
+  Report( name, "frames", nFrames, "" );
+  Report( name, "packets", nPackets, "" );
+  Report( name, "feed_frames_per_s", nFrames / ( tiFeed / 1e9 ), "1/s" );
+  Report( name, "feed_ns_per_byte", tiFeed / nWords, "ns" );
+  Report( name, "poll_frames_per_s", nFrames / ( tiPoll / 1e9 ), "1/s" );
+  Report( name, "poll_ns_per_byte", tiPoll / nWords, "ns" );
+
+  // crc per EX frame
+  volatile uint32_t sink = 0;
+  double tiCrc = Measure( [&]()
+  {
+    for( size_t f = 0; f < nEx; f++ )
+    {
+      uint8_t len = pFrames[ f ].lenByte & 0x1F;
+      uint8_t crc = RxJetiExCrc::Crc8Update( 0, pFrames[ f ].lenByte );
+      for( uint8_t j = 0; j < len - 1; j++ )
+        crc = RxJetiExCrc::Crc8Update( crc, pFrames[ f ].body[ j ] );
+      sink += crc == pFrames[ f ].body[ len - 1 ];
+    }
+  } );
+  Report( name, "crc_ns_per_frame", nEx ? tiCrc / nEx : 0, "ns" );
+
+  // decrypt per EX frame (frames without key are passed through)
+  RxJetiExCrypt crypt;
+  uint8_t       buf[ 32 ];
+  double tiCrypt = Measure( [&]()
+  {
+    for( size_t f = 0; f < nEx; f++ )
+    {
+      memcpy( buf, pFrames[ f ].body, 32 );
+      crypt.Decrypt( buf, pFrames[ f ].lenByte & 0x1F );
+      sink += buf[ 5 ];
+    }
+  } );
+  Report( name, "decrypt_ns_per_frame", nEx ? tiCrypt / nEx : 0, "ns" );
+
+  // decrypted data frames with good crc for value decode, dictionary of the whole corpus
+  Frame * pData = (Frame *)malloc( ( nEx + 1 ) * sizeof( Frame ) );
+  size_t  nData = 0;
+  for( size_t f = 0; f < nEx; f++ )
+  {
+    uint8_t len = pFrames[ f ].lenByte & 0x1F;
+    uint8_t crc = RxJetiExCrc::Crc8Update( 0, pFrames[ f ].lenByte );
+    for( uint8_t j = 0; j < len - 1; j++ )
+      crc = RxJetiExCrc::Crc8Update( crc, pFrames[ f ].body[ j ] );
+    if( crc != pFrames[ f ].body[ len - 1 ] || ( pFrames[ f ].lenByte >> 6 ) != 1 )
+      continue;
+    pData[ nData ] = pFrames[ f ];
+    crypt.Decrypt( pData[ nData ].body, len );
+    nData++;
+  }
+  static BenchDecode decode;
+  decode.ResetDictionary();
+  decode.Feed( pWords, nWords );
+
+  size_t nValues = 0;
+  double tiDecode = Measure( [&]()
+  {
+    nValues = 0;
+    for( size_t f = 0; f < nData; f++ )
+      nValues += decode.DecodeFrame( pData[ f ].body, pData[ f ].lenByte & 0x1F );
+  } );
+  Report( name, "decode_ns_per_value", nValues ? tiDecode / nValues : 0, "ns" );
+
+  // label lookup of all decoded values
+  Key *  pKeys = (Key *)malloc( ( nValues + 1 ) * sizeof( Key ) );
+  size_t nKeys = 0;
+  for( size_t f = 0; f < nData; f++ )
+  {
+    const uint8_t * p   = pData[ f ].body;
+    uint8_t         len = pData[ f ].lenByte & 0x1F;
+    for( uint8_t j = 5; j + 1 < len - 1 && nKeys < nValues; )
+    {
+      static const uint8_t size[ 16 ] = { 1, 2, 0, 0, 3, 3, 0, 0, 4, 4 };
+      uint8_t id = p[ j ] >> 4, type = p[ j ] & 0x0F;
+      j++;
+      if( id == 0 )
+        id = p[ j++ ];
+      memcpy( &pKeys[ nKeys ].serialId, p, 4 );
+      pKeys[ nKeys++ ].id = id;
+      if( size[ type ] == 0 )
+        break;
+      j += size[ type ];
+    }
+  }
+  double tiLookup = Measure( [&]()
+  {
+    for( size_t k = 0; k < nKeys; k++ )
+      sink += decode.Lookup( pKeys[ k ].serialId, pKeys[ k ].id ) != NULL;
+  } );
+  Report( name, "lookup_ns", nKeys ? tiLookup / nKeys : 0, "ns" );
+
+  free( pKeys );
+  free( pData );
+  free( pFrames );
+  free( pWords );
+}
+
+// lookup cost by dictionary size: sensors with 15 labels each
+static void BenchLookupScaling()
+{
+  static const uint8_t sensorCounts[] = { 1, 2, 4, 8, 16 };
+  RxJetiEncode encode;
+  uint16_t     words[ RXJETIEX_ENCODE_MAX ];
+
+  for( size_t s = 0; s < sizeof( sensorCounts ); s++ )
+  {
+    static BenchDecode decode;
+    decode.ResetDictionary();
+
+    uint8_t nSensors = sensorCounts[ s ];
+    Key     keys[ 16 * 15 ];
+    size_t  nKeys = 0;
+    for( uint8_t i = 0; i < nSensors; i++ )
+    {
+      uint32_t serialId = 0xA4090001UL + ( (uint32_t)i << 8 );
+      decode.Feed( words, encode.EncodeName( words, serialId, "Sensor" ) );
+      for( uint8_t id = 1; id <= 15; id++ )
+      {
+        decode.Feed( words, encode.EncodeLabel( words, serialId, id, "Value", "V" ) );
+        keys[ nKeys ].serialId = serialId;
+        keys[ nKeys++ ].id     = id;
+      }
+    }
+
+    volatile uint32_t sink = 0;
+    double tiHit  = Measure( [&](){ for( size_t k = 0; k < nKeys; k++ ) sink += decode.Lookup( keys[ k ].serialId, keys[ k ].id ) != NULL; } );
+    double tiMiss = Measure( [&](){ for( size_t k = 0; k < nKeys; k++ ) sink += decode.Lookup( keys[ k ].serialId ^ 0x80000000UL, keys[ k ].id ) != NULL; } );
+
+    char name[ 32 ];
+    snprintf( name, sizeof( name ), "labels_%u", (unsigned)nKeys );
+    Report( name, "lookup_hit_ns", tiHit / nKeys, "ns" );
+    Report( name, "lookup_miss_ns", tiMiss / nKeys, "ns" );
+  }
+}
+
+int main( int argc, char * argv[] )
+{
+  // options first, they apply to all files
+  int nFiles = 0;
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-j" ) == 0 )
+      s_bJson = true;
+    else
+      nFiles++;
+  }
+
+  for( int i = 1; i < argc; i++ )
+    if( strcmp( argv[i], "-j" ) != 0 )
+      BenchCorpus( argv[i] );
+
+  if( nFiles == 0 )
+  {
+    static const char * corpus[] = { "basic", "crypt", "noisy", "many" };
+    for( size_t i = 0; i < sizeof( corpus ) / sizeof( corpus[0] ); i++ )
+    {
+      char path[ 256 ];
+      snprintf( path, sizeof( path ), "%s/%s.jx9", RXJETIEX_CORPUS_DIR, corpus[i] );
+      BenchCorpus( path );
+    }
+  }
+
+  BenchLookupScaling();
+  return 0;
+}
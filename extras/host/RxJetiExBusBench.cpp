@@ -0,0 +1,212 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExBusBench - host benchmark of RxJetiExBusDecode over EX Bus captures:
+                     decoded frames, Feed() throughput, CPU load at 125/250 kbaud and
+                     channel latency (time from the last byte of a channel frame to its packet)
+                     
+                     usage: RxJetiExBusBench [-j] [captures]  (extras/corpus/<name>.exb if omitted)
+                            -j  JSON lines for scripts, one measurement per line
+
+                     The captures are synthetic, written by RxJetiExGen:
+                       exbus.exb    -n 150 -s 4 -v 6 -b 16
+                       exnoisy.exb  -n 150 -s 4 -v 6 -b 16 -e 0.02 -d 0.002 -r 7
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include "RxJetiExBus.h"
+
+#ifndef RXJETIEX_CORPUS_DIR
+  #define RXJETIEX_CORPUS_DIR "extras/corpus"
+#endif
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool s_bJson = false;
+
+static void Report( const char * pCorpus, const char * pMetric, double value, const char * pUnit )
+{
+  if( s_bJson )
+    printf( "{\"corpus\":\"%s\",\"metric\":\"%s\",\"value\":%.3f,\"unit\":\"%s\"}\n", pCorpus, pMetric, value, pUnit );
+  else
+    printf( "%-10s %-22s %14.2f %s\n", pCorpus, pMetric, value, pUnit );
+}
+
+// EX Bus decoder with its telemetry decoder
+struct Decoder
+{
+  Decoder() : bus( &ex ) {}
+  RxJetiDecode      ex;
+  RxJetiExBusDecode bus;
+};
+
+static uint32_t s_nPackets[ RxJetiExPacket::PACKET_JETIBOX + 1 ];
+static bool     s_bChannels;  // channel packet emitted by the last Feed()
+static uint32_t s_chkChannels;
+
+static void CountPacket( RxJetiExPacket * pPacket, void * /* pContext */ )
+{
+  uint8_t type = pPacket->GetPacketType();
+  if( type <= RxJetiExPacket::PACKET_JETIBOX )
+    s_nPackets[ type ]++;
+  if( type == RxJetiExPacket::PACKET_CHANNELS )
+  {
+    RxJetiExPacketChannels * pChannels = (RxJetiExPacketChannels *)pPacket;
+    s_bChannels = true;
+    for( uint8_t i = 0; i < pChannels->GetCount(); i++ )
+      s_chkChannels += pChannels->GetRaw( i );
+  }
+}
+
+static int CompareU32( const void * p1, const void * p2 )
+{
+  uint32_t v1 = *(const uint32_t *)p1;
+  uint32_t v2 = *(const uint32_t *)p2;
+  return v1 < v2 ? -1 : v1 > v2;
+}
+
+static void BenchCapture( const char * pPath )
+{
+  FILE * fp = fopen( pPath, "rb" );
+  if( !fp )
+  {
+    fprintf( stderr, "can't open %s\n", pPath );
+    return;
+  }
+  fseek( fp, 0, SEEK_END );
+  size_t nBytes = ftell( fp );
+  fseek( fp, 0, SEEK_SET );
+  uint8_t * pBytes = (uint8_t *)malloc( nBytes ? nBytes : 1 );
+  nBytes = fread( pBytes, 1, nBytes, fp );
+  fclose( fp );
+
+  const char * pName = strrchr( pPath, '/' );
+  pName = pName ? pName + 1 : pPath;
+  char corpus[ 64 ];
+  snprintf( corpus, sizeof( corpus ), "%s", pName );
+  char * pDot = strrchr( corpus, '.' );
+  if( pDot )
+    *pDot = '\0';
+
+  // decoded packets, 64 byte chunks as from an UART DMA buffer
+  {
+    Decoder * pDec = new Decoder;
+    pDec->bus.SetPacketCallback( CountPacket );
+    pDec->ex.SetPacketCallback( CountPacket );
+    memset( s_nPackets, 0, sizeof( s_nPackets ) );
+    for( size_t i = 0; i < nBytes; i += 64 )
+      pDec->bus.Feed( &pBytes[ i ], nBytes - i < 64 ? nBytes - i : 64 );
+    delete pDec;
+
+    Report( corpus, "bytes", nBytes, "" );
+    Report( corpus, "channel frames", s_nPackets[ RxJetiExPacket::PACKET_CHANNELS ], "" );
+    Report( corpus, "jetibox requests", s_nPackets[ RxJetiExPacket::PACKET_JETIBOX ], "" );
+    Report( corpus, "jetibox texts", s_nPackets[ RxJetiExPacket::PACKET_TEXT ], "" );
+    Report( corpus, "telemetry values", s_nPackets[ RxJetiExPacket::PACKET_VALUE ], "" );
+    Report( corpus, "telemetry names", s_nPackets[ RxJetiExPacket::PACKET_NAME ] + s_nPackets[ RxJetiExPacket::PACKET_LABEL ], "" );
+    Report( corpus, "errors", s_nPackets[ RxJetiExPacket::PACKET_ERROR ], "" );
+  }
+
+  // throughput of Feed(), whole capture per round, repeated for at least 100 ms
+  {
+    Decoder * pDec = new Decoder;
+    pDec->bus.SetPacketCallback( CountPacket );
+    pDec->ex.SetPacketCallback( CountPacket );
+    uint64_t nRounds = 0;
+    uint64_t tiStart = NanoTime();
+    uint64_t tiElapsed;
+    do
+    {
+      for( size_t i = 0; i < nBytes; i += 64 )
+        pDec->bus.Feed( &pBytes[ i ], nBytes - i < 64 ? nBytes - i : 64 );
+      nRounds++;
+    } while( ( tiElapsed = NanoTime() - tiStart ) < 100000000ULL );
+    delete pDec;
+
+    double nsPerByte = (double)tiElapsed / ( nRounds * nBytes );
+    Report( corpus, "feed", nsPerByte, "ns/byte" );
+    Report( corpus, "feed", 1e3 / nsPerByte, "MB/s" );
+    Report( corpus, "cpu load 125k", nsPerByte * 12500 / 1e7, "%" );  // 10 bits per byte
+    Report( corpus, "cpu load 250k", nsPerByte * 25000 / 1e7, "%" );
+  }
+
+  // channel latency: bytes fed one by one as from a receive interrupt,
+  // time of the Feed() call with the last byte of a channel frame (incl. clock reading).
+  // max. includes preemption by the host OS, p99 doesn't
+  {
+    enum { PASSES = 10 };
+    Decoder * pDec = new Decoder;
+    pDec->bus.SetPacketCallback( CountPacket );
+    pDec->ex.SetPacketCallback( CountPacket );
+    uint32_t * pLatency = (uint32_t *)malloc( PASSES * ( nBytes / 8 + 1 ) * sizeof( uint32_t ) ); // frames are >= 8 bytes
+    uint64_t tiSum = 0;
+    uint32_t nFrames = 0;
+    for( int pass = 0; pass < PASSES; pass++ )
+    {
+      for( size_t i = 0; i < nBytes; i++ )
+      {
+        s_bChannels = false;
+        uint64_t tiStart = NanoTime();
+        pDec->bus.Feed( &pBytes[ i ], 1 );
+        uint64_t tiElapsed = NanoTime() - tiStart;
+        if( s_bChannels )
+        {
+          tiSum += tiElapsed;
+          pLatency[ nFrames++ ] = (uint32_t)tiElapsed;
+        }
+      }
+    }
+    delete pDec;
+
+    qsort( pLatency, nFrames, sizeof( uint32_t ), CompareU32 );
+    Report( corpus, "channel latency avg", nFrames ? (double)tiSum / nFrames : 0, "ns" );
+    Report( corpus, "channel latency p99", nFrames ? pLatency[ nFrames * 99 / 100 ] : 0, "ns" );
+    Report( corpus, "channel latency max", nFrames ? pLatency[ nFrames - 1 ] : 0, "ns" );
+    free( pLatency );
+  }
+
+  free( pBytes );
+}
+
+int main( int argc, char * argv[] )
+{
+  // options first, they apply to all captures
+  int nFiles = 0;
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-j" ) == 0 )
+      s_bJson = true;
+    else
+      nFiles++;
+  }
+
+  for( int i = 1; i < argc; i++ )
+    if( strcmp( argv[i], "-j" ) != 0 )
+      BenchCapture( argv[i] );
+
+  if( nFiles == 0 )
+  {
+    static const char * corpus[] = { "exbus", "exnoisy" };
+    for( size_t i = 0; i < sizeof( corpus ) / sizeof( corpus[0] ); i++ )
+    {
+      char path[ 256 ];
+      snprintf( path, sizeof( path ), "%s/%s.exb", RXJETIEX_CORPUS_DIR, corpus[i] );
+      BenchCapture( path );
+    }
+  }
+
+  printf( "checksum %08x\n", s_chkChannels ); // keeps the results alive
+  return 0;
+}
@@ -0,0 +1,119 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCrcBench - host microbenchmark, CRC8 and CRC16 bit loop vs. lookup table
+                     per 29 byte EX frame (length byte + 28 data bytes) and
+                     per 54 byte EX Bus frame (24 channels without crc)
+                     
+                     usage: RxJetiExCrcBench [number of frames]
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include "RxJetiExCrc.h"
+
+#if defined (__x86_64__) || defined (__i386__)
+  #include <x86intrin.h>
+  #define HAVE_RDTSC
+#endif
+
+enum { FRAME_LEN = 29, BUS_FRAME_LEN = 54, NUM_FRAMES = 1024 };
+
+static uint8_t s_frames[ NUM_FRAMES ][ BUS_FRAME_LEN ];
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t Cycles()
+{
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+template< typename T, T (*CRC)( T, uint8_t ), int LEN >
+static T Run( uint32_t nFrames, const char * pName )
+{
+  T        sum      = 0;
+  uint64_t tiStart  = NanoTime();
+  uint64_t cyStart  = Cycles();
+
+  for( uint32_t n = 0; n < nFrames; n++ )
+  {
+    const uint8_t * pFrame = s_frames[ n % NUM_FRAMES ];
+    T crc = 0;
+    for( int i = 0; i < LEN; i++ )
+      crc = CRC( crc, pFrame[ i ] );
+    sum ^= crc;
+  }
+
+  uint64_t cyElapsed = Cycles() - cyStart;
+  uint64_t tiElapsed = NanoTime() - tiStart;
+  printf( "%-8s %8.2f ns/frame %8.1f cycles/frame\n", pName, (double)tiElapsed / nFrames, (double)cyElapsed / nFrames );
+  return sum;
+}
+
+static uint8_t Crc8Table( uint8_t crc, uint8_t c )
+{
+#ifdef RXJETIEX_CRC_BITWISE
+  return RxJetiExCrc::Crc8UpdateBitwise( crc, c );
+#else
+  return RxJetiExCrc::m_crc8Table[ (uint8_t)( crc ^ c ) ];
+#endif
+}
+
+static uint16_t Crc16Table( uint16_t crc, uint8_t c )
+{
+#ifdef RXJETIEX_CRC_BITWISE
+  return RxJetiExCrc::Crc16UpdateBitwise( crc, c );
+#else
+  return ( crc >> 8 ) ^ RxJetiExCrc::m_crc16Table[ (uint8_t)( crc ^ c ) ];
+#endif
+}
+
+int main( int argc, char * argv[] )
+{
+  uint32_t nFrames = argc > 1 ? strtoul( argv[1], NULL, 0 ) : 10000000;
+
+  srand( 1 );
+  for( int n = 0; n < NUM_FRAMES; n++ )
+    for( int i = 0; i < BUS_FRAME_LEN; i++ )
+      s_frames[ n ][ i ] = rand();
+
+  // both implementations must agree
+  for( int i = 0; i < 256; i++ )
+    for( int c = 0; c < 256; c++ )
+      if( Crc8Table( i, c ) != RxJetiExCrc::Crc8UpdateBitwise( i, c ) )
+      {
+        printf( "CRC mismatch crc=%d c=%d\n", i, c );
+        return 1;
+      }
+  for( int i = 0; i < 65536; i++ )
+    for( int c = 0; c < 256; c++ )
+      if( Crc16Table( i, c ) != RxJetiExCrc::Crc16UpdateBitwise( i, c ) )
+      {
+        printf( "CRC16 mismatch crc=%d c=%d\n", i, c );
+        return 1;
+      }
+
+  uint16_t sum = 0;
+  sum ^= Run< uint8_t, RxJetiExCrc::Crc8UpdateBitwise, FRAME_LEN >( nFrames, "bitwise" );
+  sum ^= Run< uint8_t, Crc8Table, FRAME_LEN >( nFrames, "table" );
+  sum ^= Run< uint16_t, RxJetiExCrc::Crc16UpdateBitwise, BUS_FRAME_LEN >( nFrames, "bitwise16" );
+  sum ^= Run< uint16_t, Crc16Table, BUS_FRAME_LEN >( nFrames, "table16" );
+
+  printf( "checksum %04x\n", sum ); // keeps the results alive
+  return 0;
+}
@@ -0,0 +1,117 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCryptBench - host microbenchmark, EX frame decryption mask per byte
+                       vs. cached keystream per 29 byte EX buffer
+                     
+                       usage: RxJetiExCryptBench [number of frames] [number of keys]
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include "RxJetiExCrypt.h"
+
+#if defined (__x86_64__) || defined (__i386__)
+  #include <x86intrin.h>
+  #define HAVE_RDTSC
+#endif
+
+enum { FRAME_LEN = 29, NUM_FRAMES = 1024 };
+
+static uint8_t s_frames[ NUM_FRAMES ][ FRAME_LEN ];
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t Cycles()
+{
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// mask computed per byte, as done before the keystream cache
+static void DecryptBytewise( RxJetiExCrypt & /* crypt */, uint8_t * pBuf, uint8_t nPacketLen )
+{
+  for( uint8_t i = 0; i < nPacketLen - 1; i++ )
+    pBuf[ i ] ^= RxJetiExCrypt::Mask( pBuf[ 4 ], i, nPacketLen );
+}
+
+static void DecryptCached( RxJetiExCrypt & crypt, uint8_t * pBuf, uint8_t nPacketLen )
+{
+  crypt.Decrypt( pBuf, nPacketLen );
+}
+
+template< void (*DECRYPT)( RxJetiExCrypt &, uint8_t *, uint8_t ) >
+static uint8_t Run( uint32_t nFrames, const char * pName )
+{
+  RxJetiExCrypt crypt;
+  uint8_t  buf[ FRAME_LEN ];
+  uint8_t  sum      = 0;
+  uint64_t tiStart  = NanoTime();
+  uint64_t cyStart  = Cycles();
+
+  for( uint32_t n = 0; n < nFrames; n++ )
+  {
+    memcpy( buf, s_frames[ n % NUM_FRAMES ], FRAME_LEN );
+    DECRYPT( crypt, buf, FRAME_LEN );
+    sum ^= buf[ n % ( FRAME_LEN - 1 ) ];
+  }
+
+  uint64_t cyElapsed = Cycles() - cyStart;
+  uint64_t tiElapsed = NanoTime() - tiStart;
+  printf( "%-8s %8.2f ns/frame %8.1f cycles/frame\n", pName, (double)tiElapsed / nFrames, (double)cyElapsed / nFrames );
+  return sum;
+}
+
+int main( int argc, char * argv[] )
+{
+  uint32_t nFrames = argc > 1 ? strtoul( argv[1], NULL, 0 ) : 10000000;
+  uint32_t nKeys   = argc > 2 ? strtoul( argv[2], NULL, 0 ) : 2; // one key per sensor
+
+  srand( 1 );
+  for( int n = 0; n < NUM_FRAMES; n++ )
+  {
+    for( int i = 0; i < FRAME_LEN; i++ )
+      s_frames[ n ][ i ] = rand();
+    s_frames[ n ][ 4 ] = 0x10 + ( n % ( nKeys ? nKeys : 1 ) ) * 0x11; // key, never 0
+  }
+
+  // both implementations must agree
+  RxJetiExCrypt crypt;
+  for( int n = 0; n < NUM_FRAMES; n++ )
+  {
+    for( uint8_t len = 6; len <= FRAME_LEN; len++ )
+    {
+      uint8_t a[ FRAME_LEN ], b[ FRAME_LEN ];
+      memcpy( a, s_frames[ n ], FRAME_LEN );
+      memcpy( b, s_frames[ n ], FRAME_LEN );
+      DecryptBytewise( crypt, a, len );
+      crypt.Decrypt( b, len );
+      if( memcmp( a, b, FRAME_LEN ) != 0 )
+      {
+        printf( "decrypt mismatch frame=%d len=%d\n", n, len );
+        return 1;
+      }
+    }
+  }
+
+  uint8_t sum = 0;
+  sum ^= Run< DecryptBytewise >( nFrames, "bytewise" );
+  sum ^= Run< DecryptCached >( nFrames, "cached" );
+
+  printf( "checksum %02x\n", sum ); // keeps the results alive
+  return 0;
+}
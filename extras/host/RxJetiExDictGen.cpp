@@ -0,0 +1,150 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExDictGen - host tool, generates a flash (PROGMEM) sensor dictionary from a capture
+                    or a saved dictionary, for RxJetiDecode::SetFlashDictionary()
+                   
+                    usage: RxJetiExDictGen [-d dictionary] [-n name] [capture file]  > JetiDictionary.h
+                           -d  read dictionary saved with SaveDictionary() instead of a capture
+                           -n  name of the generated table, default jetiDictionary
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <stdlib.h>
+#include "RxJetiExDecode.h"
+
+struct DictEntry
+{
+  uint32_t     serialId;
+  uint8_t      id;
+  const char * pstrText;
+  const char * pstrUnit;
+};
+
+static DictEntry * AddEntry( DictEntry * pEntries, size_t * pnEntries, uint32_t serialId, uint8_t id, const char * pstrText, const char * pstrUnit )
+{
+  pEntries = (DictEntry *)realloc( pEntries, ( *pnEntries + 1 ) * sizeof( DictEntry ) );
+  DictEntry * pEntry = &pEntries[ ( *pnEntries )++ ];
+  pEntry->serialId = serialId;
+  pEntry->id       = id;
+  pEntry->pstrText = pstrText;
+  pEntry->pstrUnit = pstrUnit;
+  return pEntries;
+}
+
+static int CompareEntry( const void * p1, const void * p2 )
+{
+  const DictEntry * e1 = (const DictEntry *)p1;
+  const DictEntry * e2 = (const DictEntry *)p2;
+  if( e1->serialId != e2->serialId )
+    return e1->serialId < e2->serialId ? -1 : 1;
+  return (int)e1->id - (int)e2->id;
+}
+
+// C string literal
+static void PrintString( const char * pStr )
+{
+  putchar( '"' );
+  for( ; *pStr; pStr++ )
+  {
+    unsigned char c = (unsigned char)*pStr;
+    if( c == '"' || c == '\\' )
+      printf( "\\%c", c );
+    else if( c < 0x20 || c >= 0x7F )
+      printf( "\\%03o", c ); // octal, no ambiguity with following characters
+    else
+      putchar( c );
+  }
+  putchar( '"' );
+}
+
+int main( int argc, char * argv[] )
+{
+  const char * pPath     = NULL;
+  const char * pDictPath = NULL;
+  const char * pTable    = "jetiDictionary";
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-d" ) == 0 && i + 1 < argc )
+      pDictPath = argv[ ++i ];
+    else if( strcmp( argv[i], "-n" ) == 0 && i + 1 < argc )
+      pTable = argv[ ++i ];
+    else
+      pPath = argv[i];
+  }
+
+  static RxJetiDecode jetiDecode;
+  if( pDictPath )
+  {
+    FILE * fp = fopen( pDictPath, "rb" );
+    RxJetiExFileReader reader( fp );
+    if( fp == NULL || !jetiDecode.LoadDictionary( reader ) )
+    {
+      fprintf( stderr, "cannot read dictionary %s\n", pDictPath );
+      return 1;
+    }
+    fclose( fp );
+  }
+  else
+  {
+    RxJetiExPosixSerial port( pPath );
+    jetiDecode.Start( &port );
+    if( !port.IsOpen() )
+    {
+      fprintf( stderr, "cannot open %s\n", pPath );
+      return 1;
+    }
+    while( jetiDecode.GetPacket() || !port.IsEof() )
+      ;
+  }
+
+  // collect names and labels, sorted by (serialId, id) for binary search in the decoder
+  size_t      nEntries = 0;
+  DictEntry * pEntries = NULL;
+  for( RxJetiExPacketName * pName = jetiDecode.GetFirstName(); pName; pName = jetiDecode.GetNextName( pName ) )
+  {
+    pEntries = AddEntry( pEntries, &nEntries, pName->GetSerialId(), 0, pName->GetName(), NULL );
+    for( RxJetiExPacketLabel * pLabel = jetiDecode.GetFirstLabel( pName ); pLabel; pLabel = jetiDecode.GetNextLabel( pLabel ) )
+      pEntries = AddEntry( pEntries, &nEntries, pLabel->GetSerialId(), pLabel->GetId(), pLabel->GetLabel(), pLabel->GetUnit() );
+  }
+  qsort( pEntries, nEntries, sizeof( DictEntry ), CompareEntry );
+
+  // strings and table in flash
+  printf( "// generated by RxJetiExDictGen from %s, do not edit\n", pDictPath ? pDictPath : pPath ? pPath : "stdin" );
+  printf( "// usage: jetiDecode.SetFlashDictionary( %s, sizeof( %s ) / sizeof( %s[ 0 ] ) );\n\n", pTable, pTable, pTable );
+  printf( "#include \"RxJetiExFlash.h\"\n\n" );
+  for( size_t i = 0; i < nEntries; i++ )
+  {
+    printf( "static const char %s_t%u[] RXJETIEX_PROGMEM = ", pTable, (unsigned)i );
+    PrintString( pEntries[ i ].pstrText );
+    printf( ";\n" );
+    if( pEntries[ i ].pstrUnit )
+    {
+      printf( "static const char %s_u%u[] RXJETIEX_PROGMEM = ", pTable, (unsigned)i );
+      PrintString( pEntries[ i ].pstrUnit );
+      printf( ";\n" );
+    }
+  }
+
+  printf( "\nstatic const RxJetiExFlashEntry %s[] RXJETIEX_PROGMEM =\n{\n", pTable );
+  for( size_t i = 0; i < nEntries; i++ )
+  {
+    printf( "  { 0x%08X, %3u, %s_t%u, ", pEntries[ i ].serialId, pEntries[ i ].id, pTable, (unsigned)i );
+    if( pEntries[ i ].pstrUnit )
+      printf( "%s_u%u },\n", pTable, (unsigned)i );
+    else
+      printf( "NULL },\n" );
+  }
+  printf( "};\n" );
+
+  fprintf( stderr, "%u entries\n", (unsigned)nEntries );
+  free( pEntries );
+  return 0;
+}
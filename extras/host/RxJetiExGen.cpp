@@ -0,0 +1,264 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExGen - host tool, synthetic EX traffic with RxJetiEncode, writes a 9 bit capture
+                (little endian uint16 per word) for RxJetiExReplay, benchmarks and stress tests,
+                or an EX Bus byte capture for RxJetiExBusBench
+                     
+                usage: RxJetiExGen [options] > capture.jx9
+                       -n  rounds, one data frame per sensor and round (default 10000)
+                       -s  sensors (default 4)
+                       -v  values per sensor (default 6, all data types, max. 15)
+                       -k  encryption key (default 0 = off)
+                       -e  probability of a corrupted EX frame (bit flip, default 0)
+                       -d  probability of a dropped character (default 0)
+                       -a  probability of an alarm per round (default 0.01)
+                       -t  probability of a JetiBox text per round (default 0.1)
+                       -r  random seed
+                       -b  EX Bus capture with number of servo channels (default 0 = EX stream, max. 24):
+                           per EX frame a channel frame, a telemetry request and the EX frame as answer,
+                           JetiBox text as answer to a JetiBox request. -e and -d apply to EX Bus frames and bytes
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include "RxJetiExEncode.h"
+
+static double   s_errorRate = 0;
+static double   s_dropRate  = 0;
+static uint32_t s_nFrames   = 0;
+static uint32_t s_nErrors   = 0;
+static uint32_t s_nDrops    = 0;
+static uint32_t s_nWords    = 0;
+static uint8_t  s_nChannels = 0; // EX Bus capture if > 0
+static uint8_t  s_packetId  = 0;
+static uint32_t s_nCycles   = 0;
+
+static double Random()
+{
+  return rand() / ( RAND_MAX + 1.0 );
+}
+
+// EX Bus cycle: channel frame, request, device answer with EX frame or JetiBox text
+static void EmitBusFrame( uint8_t * pFrame, uint8_t nBytes )
+{
+  s_nFrames++;
+  if( s_errorRate > 0 && Random() < s_errorRate )
+  {
+    pFrame[ 2 + rand() % ( nBytes - 2 ) ] ^= 1 << ( rand() % 8 ); // length, data or crc
+    s_nErrors++;
+  }
+  for( uint8_t i = 0; i < nBytes; i++ )
+  {
+    if( s_dropRate > 0 && Random() < s_dropRate )
+    {
+      s_nDrops++;
+      continue;
+    }
+    fwrite( &pFrame[ i ], 1, 1, stdout );
+    s_nWords++;
+  }
+}
+
+static void EmitBus( uint16_t * pWords, uint8_t nWords )
+{
+  uint8_t  frame[ RXJETIEX_BUS_FRAME_MAX ];
+  uint16_t channels[ 24 ];
+  for( uint8_t i = 0; i < s_nChannels; i++ )
+    channels[ i ] = 8 * ( 1100 + ( s_nCycles * 7 + i * 50 ) % 800 ); // 1/8 us
+  s_nCycles++;
+  EmitBusFrame( frame, RxJetiExBusEncode::EncodeChannels( frame, s_packetId++, channels, s_nChannels ) );
+
+  uint8_t packetId = s_packetId++;
+  if( pWords[ 0 ] == 0x00FE ) // JetiBox text
+  {
+    char text[ 33 ];
+    uint8_t n = 0;
+    for( ; n + 2 < nWords && n < 32; n++ )
+      text[ n ] = (char)pWords[ n + 1 ];
+    text[ n ] = '\0';
+    EmitBusFrame( frame, RxJetiExBusEncode::EncodeJetiBoxRequest( frame, packetId, ( s_nCycles & 1 ) ? RxJetiExPacketJetiBox::BUTTON_RIGHT : 0 ) );
+    EmitBusFrame( frame, RxJetiExBusEncode::EncodeJetiBox( frame, packetId, text ) );
+  }
+  else
+  {
+    EmitBusFrame( frame, RxJetiExBusEncode::EncodeTelemetryRequest( frame, packetId ) );
+    EmitBusFrame( frame, RxJetiExBusEncode::EncodeTelemetry( frame, packetId, pWords, nWords ) );
+  }
+}
+
+// write frame with injected errors
+static void Emit( uint16_t * pWords, uint8_t nWords, bool bEx )
+{
+  if( nWords == 0 )
+    return;
+  if( s_nChannels )
+  {
+    EmitBus( pWords, nWords );
+    return;
+  }
+  s_nFrames++;
+  if( bEx && s_errorRate > 0 && Random() < s_errorRate )
+  {
+    pWords[ 3 + rand() % ( nWords - 3 ) ] ^= 1 << ( rand() % 8 ); // body or crc
+    s_nErrors++;
+  }
+  for( uint8_t i = 0; i < nWords; i++ )
+  {
+    if( s_dropRate > 0 && Random() < s_dropRate )
+    {
+      s_nDrops++;
+      continue;
+    }
+    fwrite( &pWords[ i ], sizeof( uint16_t ), 1, stdout );
+    s_nWords++;
+  }
+}
+
+struct Sensor
+{
+  uint32_t serialId;
+  char     name[ 16 ];
+  int32_t  values[ 16 ];
+  uint8_t  nextText; // 0 = name, then labels
+};
+
+// data type of value id: all types of enDataType in turn
+static const uint8_t s_types[] = { RxJetiExPacket::TYPE_14b, RxJetiExPacket::TYPE_22b, RxJetiExPacket::TYPE_6b, RxJetiExPacket::TYPE_30b,
+                                   RxJetiExPacket::TYPE_GPS, RxJetiExPacket::TYPE_GPS, RxJetiExPacket::TYPE_DT,  RxJetiExPacket::TYPE_DT };
+
+static uint8_t TypeOf( uint8_t id ){ return s_types[ ( id - 1 ) % sizeof( s_types ) ]; }
+
+static int32_t Limit( uint8_t exType )
+{
+  switch( exType )
+  {
+  case RxJetiExPacket::TYPE_6b:  return 31;
+  case RxJetiExPacket::TYPE_14b: return 8191;
+  case RxJetiExPacket::TYPE_22b: return 2097151;
+  default:                       return 536870911;
+  }
+}
+
+static bool AddValue( RxJetiEncode & encode, Sensor & sensor, uint8_t id, uint32_t round )
+{
+  uint8_t exType = TypeOf( id );
+  int32_t limit  = Limit( exType );
+  int32_t & v    = sensor.values[ id ];
+
+  switch( exType )
+  {
+  case RxJetiExPacket::TYPE_GPS:
+    v += rand() % 201 - 100; // 1E-7 degrees
+    return encode.AddGPS( id, ( id & 1 ) ? 470000000 + v : -1220000000 + v, !( id & 1 ) );
+  case RxJetiExPacket::TYPE_DT:
+    if( id & 1 )
+      return encode.AddDate( id, 1 + round % 28, 1 + round % 12, 2022 );
+    return encode.AddTime( id, ( round / 3600 ) % 24, ( round / 60 ) % 60, round % 60 );
+  default:
+    v += rand() % ( limit / 16 + 1 ) - limit / 32;
+    if( v > limit || v < -limit )
+      v = 0;
+    return encode.AddValue( id, exType, v, id % 3 );
+  }
+}
+
+int main( int argc, char * argv[] )
+{
+  uint32_t nRounds    = 10000;
+  uint8_t  nSensors   = 4;
+  uint8_t  nValues    = 6;
+  uint8_t  key        = 0;
+  double   alarmRate  = 0.01;
+  double   textRate   = 0.1;
+  unsigned seed       = 1;
+
+  for( int i = 1; i + 1 < argc; i += 2 )
+  {
+    const char * pArg = argv[ i + 1 ];
+    switch( argv[ i ][ 0 ] == '-' ? argv[ i ][ 1 ] : 0 )
+    {
+    case 'n': nRounds     = strtoul( pArg, NULL, 0 ); break;
+    case 's': nSensors    = strtoul( pArg, NULL, 0 ); break;
+    case 'v': nValues     = strtoul( pArg, NULL, 0 ); break;
+    case 'k': key         = strtoul( pArg, NULL, 0 ); break;
+    case 'e': s_errorRate = atof( pArg ); break;
+    case 'd': s_dropRate  = atof( pArg ); break;
+    case 'a': alarmRate   = atof( pArg ); break;
+    case 't': textRate    = atof( pArg ); break;
+    case 'r': seed        = strtoul( pArg, NULL, 0 ); break;
+    case 'b': s_nChannels = strtoul( pArg, NULL, 0 ); break;
+    default:
+      fprintf( stderr, "unknown option %s\n", argv[ i ] );
+      return 1;
+    }
+  }
+  if( nValues > 15 )
+    nValues = 15;
+  if( s_nChannels > 24 )
+    s_nChannels = 24;
+  srand( seed );
+
+  Sensor * pSensors = (Sensor *)calloc( nSensors, sizeof( Sensor ) );
+  for( uint8_t s = 0; s < nSensors; s++ )
+  {
+    pSensors[ s ].serialId = 0xA4090000UL + ( (uint32_t)s << 8 ) + 0x01;
+    snprintf( pSensors[ s ].name, sizeof( pSensors[ s ].name ), "Sensor%u", s );
+  }
+
+  RxJetiEncode encode;
+  uint16_t     words[ RXJETIEX_ENCODE_MAX ];
+  uint32_t     nValuesOut = 0;
+  encode.SetKey( key );
+
+  for( uint32_t round = 0; round < nRounds; round++ )
+  {
+    for( uint8_t s = 0; s < nSensors; s++ )
+    {
+      Sensor & sensor = pSensors[ s ];
+
+      // one name or label per data frame, like real sensors
+      if( sensor.nextText == 0 )
+        Emit( words, encode.EncodeName( words, sensor.serialId, sensor.name ), true );
+      else
+      {
+        char label[ 16 ];
+        snprintf( label, sizeof( label ), "Value%u", sensor.nextText );
+        Emit( words, encode.EncodeLabel( words, sensor.serialId, sensor.nextText, label, "V" ), true );
+      }
+      sensor.nextText = ( sensor.nextText + 1 ) % ( nValues + 1 );
+
+      // all values, a full frame is sent and continued in the next one
+      encode.BeginData( sensor.serialId );
+      for( uint8_t id = 1; id <= nValues; id++ )
+      {
+        if( !AddValue( encode, sensor, id, round ) )
+        {
+          Emit( words, encode.EndData( words ), true );
+          AddValue( encode, sensor, id, round );
+        }
+        nValuesOut++;
+      }
+      Emit( words, encode.EndData( words ), true );
+    }
+
+    if( Random() < alarmRate )
+      Emit( words, encode.EncodeAlarm( words, 'A' + rand() % 26 ), false );
+    if( Random() < textRate )
+    {
+      char text[ 33 ];
+      snprintf( text, sizeof( text ), "Round %-10u  Jetibox  %5u", round, round % 10000 );
+      Emit( words, encode.EncodeText( words, text ), false );
+    }
+  }
+
+  fprintf( stderr, "frames %u, values %u, %s %u, corrupted frames %u, dropped %s %u\n",
+           s_nFrames, nValuesOut, s_nChannels ? "bytes" : "words", s_nWords, s_nErrors, s_nChannels ? "bytes" : "words", s_nDrops );
+  free( pSensors );
+  return 0;
+}
@@ -0,0 +1,176 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExLatency - host tool, 9th bit reconstruction for 8 bit UARTs (ESP32):
+                    strips the 9th bit of a capture and compares the former 3 character
+                    delay line with RxJetiEx9thBit against the original 9 bit words
+                     
+                    usage: RxJetiExLatency [capture file]  (stdin if omitted)
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include "RxJetiExDecode.h"
+
+static const double MS_PER_CHAR = 12 * 1000.0 / 9600; // 8O2 at 9600 baud
+
+// former emulation: 0xFE 0xFF 0x7E sequence, returns the character received 2 calls before
+class DelayLine
+{
+public:
+  DelayLine() : c_minus1( 0 ), c_minus2( 0 ), c_minus3( 0 ) {}
+  uint16_t Classify( uint8_t ch )
+  {
+    uint16_t c = ch | 0x100;
+    if( (c & 0x00ff) == 0x007e && (c_minus1 & 0x00ff) == 0x00ff && (c_minus2 & 0x00ff) == 0x00fe )
+    {
+      c_minus3 &= ~0x100;
+      c_minus2 &= ~0x100;
+      c_minus1 &= ~0x100;
+      c        &= ~0x100;
+    }
+    c_minus3 = c_minus2;
+    c_minus2 = c_minus1;
+    c_minus1 = c;
+    return c_minus3;
+  }
+protected:
+  uint16_t c_minus1;
+  uint16_t c_minus2;
+  uint16_t c_minus3;
+};
+
+class Original
+{
+public:
+  uint16_t Classify( uint16_t c ){ return c; }
+};
+
+// packet with the index of the input character that completed it
+struct Emitted
+{
+  size_t   idx;
+  uint8_t  type;
+  uint32_t key;
+};
+
+struct Run
+{
+  Emitted * pPackets;
+  size_t    nPackets;
+  size_t    idx;
+  size_t    nTagErrors;
+};
+
+static void OnPacket( RxJetiExPacket * pPacket, void * pContext )
+{
+  Run * pRun = (Run *)pContext;
+  Emitted * p = &pRun->pPackets[ pRun->nPackets++ ];
+  p->idx  = pRun->idx;
+  p->type = pPacket->GetPacketType();
+  p->key  = 0;
+  if( p->type == RxJetiExPacket::PACKET_VALUE )
+  {
+    RxJetiExPacketValue * pValue = (RxJetiExPacketValue *)pPacket;
+    p->key = pValue->GetSerialId() ^ ( pValue->GetRawValue() << 4 ) ^ pValue->GetId();
+  }
+  else if( p->type == RxJetiExPacket::PACKET_LABEL )
+    p->key = ((RxJetiExPacketLabel *)pPacket)->GetSerialId() ^ ((RxJetiExPacketLabel *)pPacket)->GetId();
+  else if( p->type == RxJetiExPacket::PACKET_NAME )
+    p->key = ((RxJetiExPacketName *)pPacket)->GetSerialId();
+}
+
+// feed character by character as an UART would deliver them
+template< class CLASSIFIER, size_t DELAY >
+static void Decode( const uint16_t * pWords, size_t nWords, bool bStrip, Run * pRun )
+{
+  static RxJetiDecode jetiDecode;
+  CLASSIFIER          classifier;
+
+  jetiDecode.ResetDictionary();
+  jetiDecode.ResetState();
+  jetiDecode.SetPacketCallback( OnPacket, pRun );
+  pRun->pPackets   = (Emitted *)malloc( ( nWords + 1 ) * sizeof( Emitted ) );
+  pRun->nPackets   = 0;
+  pRun->nTagErrors = 0;
+  for( pRun->idx = 0; pRun->idx < nWords; pRun->idx++ )
+  {
+    uint16_t c = classifier.Classify( bStrip ? (uint8_t)pWords[ pRun->idx ] : pWords[ pRun->idx ] );
+    if( pRun->idx >= DELAY && c != pWords[ pRun->idx - DELAY ] )
+      pRun->nTagErrors++;
+    jetiDecode.Feed( &c, 1 );
+  }
+}
+
+// match packets in order with the reference and report the delay in characters
+static void Report( const char * pName, const Run & ref, const Run & run )
+{
+  size_t   i = 0, j = 0, nMatched = 0, lagMax = 0;
+  uint64_t lagSum = 0;
+  while( i < ref.nPackets && j < run.nPackets )
+  {
+    const Emitted & a = ref.pPackets[ i ];
+    const Emitted & b = run.pPackets[ j ];
+    if( a.type == b.type && a.key == b.key && b.idx >= a.idx )
+    {
+      size_t lag = b.idx - a.idx;
+      lagSum += lag;
+      if( lag > lagMax )
+        lagMax = lag;
+      nMatched++;
+      i++;
+      j++;
+    }
+    else if( a.idx <= b.idx )
+      i++;
+    else
+      j++;
+  }
+
+  double lagAvg = nMatched ? (double)lagSum / nMatched : 0;
+  printf( "%-10s packets %6zu of %6zu, tag errors %6zu, delay avg %.2f max %zu chars (%.2f / %.2f ms)\n",
+          pName, nMatched, ref.nPackets, run.nTagErrors, lagAvg, lagMax, lagAvg * MS_PER_CHAR, lagMax * MS_PER_CHAR );
+}
+
+int main( int argc, char * argv[] )
+{
+  FILE * fp = argc > 1 ? fopen( argv[1], "rb" ) : stdin;
+  if( fp == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", argv[1] );
+    return 1;
+  }
+
+  size_t     nAlloc = 1 << 16;
+  size_t     nWords = 0;
+  uint16_t * pWords = (uint16_t *)malloc( nAlloc * sizeof( uint16_t ) );
+  size_t     n;
+  while( ( n = fread( &pWords[ nWords ], sizeof( uint16_t ), nAlloc - nWords, fp ) ) > 0 )
+  {
+    nWords += n;
+    if( nWords == nAlloc )
+      pWords = (uint16_t *)realloc( pWords, ( nAlloc *= 2 ) * sizeof( uint16_t ) );
+  }
+  if( fp != stdin )
+    fclose( fp );
+
+  Run ref, delay, stream;
+  Decode< Original, 0 >( pWords, nWords, false, &ref );
+  Decode< DelayLine, 2 >( pWords, nWords, true, &delay );
+  Decode< RxJetiEx9thBit, 0 >( pWords, nWords, true, &stream );
+
+  printf( "%zu characters, %.2f ms per character\n", nWords, MS_PER_CHAR );
+  Report( "delay line", ref, delay );
+  Report( "classifier", ref, stream );
+
+  free( ref.pPackets );
+  free( delay.pPackets );
+  free( stream.pPackets );
+  free( pWords );
+  return 0;
+}
@@ -0,0 +1,198 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExPty - host tool, end to end test of RxJetiExTermiosSerial (Linux):
+                a writer thread sends a 9 bit capture as parity marked byte stream
+                (0xFF 0x00 c for control characters, 0xFF 0xFF for data 0xFF) into
+                a pseudo terminal, the decoder reads the slave side with epoll
+                     
+                usage: RxJetiExPty [-r] [capture file]  (stdin if omitted)
+                       -r  real time, paced at 9600 baud
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "RxJetiExDecode.h"
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+struct Writer
+{
+  int             fd;
+  const uint8_t * pBytes;
+  size_t          nBytes;
+  bool            bRealTime;
+  volatile bool   bDone;
+};
+
+// what the UART driver delivers with mark parity and PARMRK
+static size_t MarkParity( const uint16_t * pWords, size_t nWords, uint8_t * pDst )
+{
+  size_t n = 0;
+  for( size_t i = 0; i < nWords; i++ )
+  {
+    uint8_t c = (uint8_t)pWords[ i ];
+    if( ( pWords[ i ] & 0x100 ) == 0 )
+    {
+      pDst[ n++ ] = 0xFF;
+      pDst[ n++ ] = 0x00;
+    }
+    else if( c == 0xFF )
+      pDst[ n++ ] = 0xFF;
+    pDst[ n++ ] = c;
+  }
+  return n;
+}
+
+static void * WriterThread( void * pArg )
+{
+  Writer * pWriter = (Writer *)pArg;
+  const size_t CHUNK = pWriter->bRealTime ? 8 : 64; // real time: 10 ms bursts like an UART FIFO
+  for( size_t i = 0; i < pWriter->nBytes; )
+  {
+    size_t  n = pWriter->nBytes - i < CHUNK ? pWriter->nBytes - i : CHUNK;
+    ssize_t w = write( pWriter->fd, &pWriter->pBytes[ i ], n );
+    if( w < 0 )
+      break;
+    i += w;
+    if( pWriter->bRealTime )
+      usleep( w * 1250 ); // 12 bits per character at 9600 baud (less for parity marks, close enough)
+  }
+  pWriter->bDone = true;
+  return NULL;
+}
+
+struct Result
+{
+  uint32_t nPackets[ 8 ];
+  uint32_t sum;
+};
+
+static void Count( RxJetiExPacket * pPacket, Result * pResult )
+{
+  pResult->nPackets[ pPacket->GetPacketType() & 0x07 ]++;
+  if( pPacket->GetPacketType() == RxJetiExPacket::PACKET_VALUE )
+  {
+    RxJetiExPacketValue * pValue = (RxJetiExPacketValue *)pPacket;
+    pResult->sum = pResult->sum * 31 + ( pValue->GetRawValue() ^ pValue->GetSerialId() ^ pValue->GetId() );
+  }
+}
+
+static void OnPacket( RxJetiExPacket * pPacket, void * pContext )
+{
+  Count( pPacket, (Result *)pContext );
+}
+
+int main( int argc, char * argv[] )
+{
+  bool         bRealTime = false;
+  const char * pPath     = NULL;
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-r" ) == 0 )
+      bRealTime = true;
+    else
+      pPath = argv[i];
+  }
+
+  FILE * fp = pPath ? fopen( pPath, "rb" ) : stdin;
+  if( fp == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    return 1;
+  }
+  size_t     nAlloc = 1 << 16;
+  size_t     nWords = 0;
+  uint16_t * pWords = (uint16_t *)malloc( nAlloc * sizeof( uint16_t ) );
+  size_t     n;
+  while( ( n = fread( &pWords[ nWords ], sizeof( uint16_t ), nAlloc - nWords, fp ) ) > 0 )
+  {
+    nWords += n;
+    if( nWords == nAlloc )
+      pWords = (uint16_t *)realloc( pWords, ( nAlloc *= 2 ) * sizeof( uint16_t ) );
+  }
+  if( fp != stdin )
+    fclose( fp );
+
+  // reference: 9 bit words pushed directly
+  static Result ref, live;
+  static RxJetiDecode refDecode;
+  refDecode.SetPacketCallback( OnPacket, &ref );
+  refDecode.Feed( pWords, nWords );
+
+  // pty pair
+  int master = posix_openpt( O_RDWR | O_NOCTTY );
+  if( master < 0 || grantpt( master ) != 0 || unlockpt( master ) != 0 )
+  {
+    fprintf( stderr, "cannot create pty\n" );
+    return 1;
+  }
+  char slave[ 64 ];
+  snprintf( slave, sizeof( slave ), "%s", ptsname( master ) );
+  RxJetiExTermiosSerial port( slave, true ); // the writer marks the parity
+  RxJetiDecode          jetiDecode;
+  jetiDecode.Start( &port );
+  if( !port.IsOpen() )
+  {
+    fprintf( stderr, "cannot open %s\n", slave );
+    return 1;
+  }
+
+  uint8_t * pBytes = (uint8_t *)malloc( nWords * 3 );
+  Writer    writer = { master, pBytes, MarkParity( pWords, nWords, pBytes ), bRealTime, false };
+  pthread_t thread;
+  uint64_t  tiStart = NanoTime();
+  pthread_create( &thread, NULL, WriterThread, &writer );
+
+  // decode until the writer is done and the pty stays silent
+  int nIdle = 0;
+  while( nIdle < 3 )
+  {
+    if( !port.Wait( 100 ) )
+    {
+      if( writer.bDone )
+        nIdle++;
+      continue;
+    }
+    nIdle = 0;
+    // drain the decoder, Wait() doesn't see characters already read from the port
+    do
+    {
+      RxJetiExPacket * pPacket;
+      while( ( pPacket = jetiDecode.GetPacket() ) != NULL )
+        Count( pPacket, &live );
+    } while( jetiDecode.IsPending() );
+  }
+  uint64_t tiElapsed = NanoTime() - tiStart - 300000000ULL; // without idle wait
+  pthread_join( thread, NULL );
+  close( master );
+
+  uint32_t nRef = 0, nLive = 0;
+  for( int i = 0; i < 8; i++ )
+  {
+    nRef  += ref.nPackets[ i ];
+    nLive += live.nPackets[ i ];
+  }
+  bool bMatch = memcmp( &ref, &live, sizeof( ref ) ) == 0;
+  printf( "pty %s: %zu characters, %zu bytes with parity marks\n", slave, nWords, writer.nBytes );
+  printf( "packets: %u via pty, %u reference (value checksum %08x / %08x) -> %s\n", nLive, nRef, live.sum, ref.sum, bMatch ? "match" : "MISMATCH" );
+  printf( "elapsed: %.1f ms, %.0f characters/s\n", tiElapsed / 1e6, nWords / ( tiElapsed / 1e9 ) );
+
+  free( pBytes );
+  free( pWords );
+  return bMatch ? 0 : 1;
+}
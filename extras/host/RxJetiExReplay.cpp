@@ -0,0 +1,330 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExReplay - host tool, replays a 9 bit capture file or pty through 
+                   RxJetiDecode, prints packets and decoder throughput
+                   
+                   usage: RxJetiExReplay [-q] [-b] [-s speed] [-f|-t] [capture file | pty]  (stdin if omitted)
+                          -q  quiet, statistics only
+                          -f  load capture into memory and push it with RxJetiDecode::Feed()
+                          -t  pull packets with RxJetiDecodeT (static port, no virtual calls)
+                          -l  print latest value table at end (RXJETIEX_LATEST)
+                          -d  dictionary file: loaded at start if present (warm start), saved at end
+                          -b  batch mode, one packet per EX data frame
+                          -s  clock speed factor, i.e. -s 10 runs decoder time (timeouts, latest values) 10x faster
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <time.h>
+#include "RxJetiExDecodeT.h"
+
+static uint64_t NanoTime()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void PrintPacket( RxJetiExPacket * pPacket )
+{
+  switch( pPacket->GetPacketType() )
+  {
+  case RxJetiExPacket::PACKET_NAME:
+    {
+      RxJetiExPacketName * pName = (RxJetiExPacketName *)pPacket;
+      printf( "Name   %08x: %s\n", pName->GetSerialId(), pName->GetName() );
+    }
+    break;
+  case RxJetiExPacket::PACKET_LABEL:
+    {
+      RxJetiExPacketLabel * pLabel = (RxJetiExPacketLabel *)pPacket;
+      printf( "Label  %08x/%d: %s [%s]\n", pLabel->GetSerialId(), pLabel->GetId(), pLabel->GetLabel(), pLabel->GetUnit() );
+    }
+    break;
+  case RxJetiExPacket::PACKET_VALUE:
+    {
+      RxJetiExPacketValue * pValue = (RxJetiExPacketValue *)pPacket;
+      float fValue;
+      printf( "Value  %08x/%d %s: ", pValue->GetSerialId(), pValue->GetId(), pValue->GetLabel() );
+      if( pValue->GetFloat( &fValue ) )
+        printf( "%.2f", fValue );
+      else if( pValue->GetLatitude( &fValue ) || pValue->GetLongitude( &fValue ) )
+        printf( "%.5f", fValue );
+      else
+        printf( "0x%x", pValue->GetRawValue() );
+      printf( " %s type %d\n", pValue->GetUnit(), pValue->GetExType() );
+    }
+    break;
+  case RxJetiExPacket::PACKET_ALARM:
+    {
+      RxJetiPacketAlarm * pAlarm = (RxJetiPacketAlarm *)pPacket;
+      printf( "Alarm  code %d, sound %d\n", pAlarm->GetCode(), pAlarm->GetSound() );
+    }
+    break;
+  case RxJetiExPacket::PACKET_TEXT:
+    printf( "Text   %s\n", ((RxJetiPacketText *)pPacket)->m_textBuffer );
+    break;
+  case RxJetiExPacket::PACKET_ERROR:
+    printf( "Error  reason %d\n", ((RxJetiExPacketError *)pPacket)->GetReason() );
+    break;
+  case RxJetiExPacket::PACKET_BATCH:
+    {
+      RxJetiExPacketBatch * pBatch = (RxJetiExPacketBatch *)pPacket;
+      RxJetiExPacketValue   value;
+      for( uint8_t i = 0; pBatch->GetValue( i, &value ); i++ )
+        PrintPacket( &value );
+    }
+    break;
+  }
+}
+
+static bool     s_bQuiet  = false;
+static bool     s_bLatest = false;
+static const char * s_pDictPath = NULL;
+static bool     s_bBatch  = false;
+static double   s_speed   = 0;     // 0 = millis()
+static uint64_t s_tiClock = 0;
+
+static uint32_t ReplayClock()
+{
+  return (uint32_t)( ( NanoTime() - s_tiClock ) * s_speed / 1e6 );
+}
+static RxJetiExValueRecord s_batch[ 16 ];
+
+static void LoadDictionary( RxJetiDecodeBase & jetiDecode )
+{
+  FILE * fp = s_pDictPath ? fopen( s_pDictPath, "rb" ) : NULL;
+  if( fp == NULL )
+    return;
+  RxJetiExFileReader reader( fp );
+  if( !jetiDecode.LoadDictionary( reader ) )
+    fprintf( stderr, "invalid dictionary %s\n", s_pDictPath );
+  fclose( fp );
+}
+
+static void SaveDictionary( RxJetiDecodeBase & jetiDecode )
+{
+  FILE * fp = s_pDictPath ? fopen( s_pDictPath, "wb" ) : NULL;
+  if( fp == NULL )
+    return;
+  RxJetiExFileWriter writer( fp );
+  if( !jetiDecode.SaveDictionary( writer ) )
+    fprintf( stderr, "cannot write dictionary %s\n", s_pDictPath );
+  fclose( fp );
+}
+static uint32_t s_nPackets[ 8 ];
+
+static void OnPacket( RxJetiExPacket * pPacket, void * /* pContext */ )
+{
+  if( pPacket->GetPacketType() == RxJetiExPacket::PACKET_BATCH )
+    s_nPackets[ RxJetiExPacket::PACKET_VALUE ] += ((RxJetiExPacketBatch *)pPacket)->GetCount();
+  else
+    s_nPackets[ pPacket->GetPacketType() & 0x07 ]++;
+  if( !s_bQuiet )
+    PrintPacket( pPacket );
+}
+
+#ifdef RXJETIEX_STATS
+static void PrintStats( const RxJetiDecodeStats & stats )
+{
+  fprintf( stderr, "stats:   bytes %u, ex text %u, ex data %u, ex msg %u, alarm %u, text %u\n",
+           stats.nBytes, stats.nExText, stats.nExData, stats.nExMsg, stats.nAlarm, stats.nText );
+  fprintf( stderr, "errors:  crc %u, length %u, type %u, timeout %u, link lost %u, unknown label %u, overflow %u\n",
+           stats.nCrcErrors, stats.nLenErrors, stats.nTypeErrors, stats.nTimeouts, stats.nLinkLost, stats.nUnknownLabel, stats.nOverflows );
+  #ifdef RXJETIEX_STATS_TIMING
+  if( stats.nTimed )
+    fprintf( stderr, "timing:  %u frames, min %u us, max %u us, avg %u us\n", stats.nTimed, stats.tiMin, stats.tiMax, stats.GetAvg() );
+  #endif
+}
+#endif
+
+#ifdef RXJETIEX_LATEST
+static void PrintLatest( RxJetiDecodeBase & jetiDecode )
+{
+  for( RxJetiExPacketName * pName = jetiDecode.GetFirstName(); pName; pName = jetiDecode.GetNextName( pName ) )
+  {
+    for( RxJetiExPacketLabel * pLabel = jetiDecode.GetFirstLabel( pName ); pLabel; pLabel = jetiDecode.GetNextLabel( pLabel ) )
+    {
+      RxJetiExPacketValue value;
+      float               fValue;
+      if( jetiDecode.GetLatest( pLabel->GetSerialId(), pLabel->GetId(), &value ) && value.GetFloat( &fValue ) )
+        printf( "Latest %08x/%d %s: %.2f %s, %u updates, %u ms\n", pLabel->GetSerialId(), pLabel->GetId(), pLabel->GetLabel(),
+                fValue, pLabel->GetUnit(), pLabel->GetLatest()->nUpdates, pLabel->GetLatest()->tiUpdate );
+    }
+  }
+}
+#endif
+
+// pull packets through serial port
+static uint64_t ReplayPort( const char * pPath )
+{
+  RxJetiExPosixSerial port( pPath );
+  RxJetiDecode        jetiDecode;
+
+  LoadDictionary( jetiDecode );
+  if( s_bBatch )
+    jetiDecode.SetBatch( s_batch, sizeof( s_batch ) / sizeof( s_batch[0] ) );
+  if( s_speed > 0 )
+    jetiDecode.SetClock( ReplayClock );
+  jetiDecode.Start( &port );
+  if( !port.IsOpen() )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    exit( 1 );
+  }
+
+  uint64_t tiStart = NanoTime();
+  for( ;; )
+  {
+    RxJetiExPacket * pPacket = jetiDecode.GetPacket();
+    if( pPacket )
+      OnPacket( pPacket, NULL );
+    else if( port.IsEof() )
+      break;
+  }
+  uint64_t tiElapsed = NanoTime() - tiStart;
+  #ifdef RXJETIEX_STATS
+  PrintStats( jetiDecode.GetStats() );
+  #endif
+  #ifdef RXJETIEX_LATEST
+  if( s_bLatest )
+    PrintLatest( jetiDecode );
+  #endif
+  SaveDictionary( jetiDecode );
+  return tiElapsed;
+}
+
+// pull packets through compile time configured decoder
+static uint64_t ReplayStatic( const char * pPath )
+{
+  static RxJetiDecodeT< RxJetiExPosixSerial, 64, 255 > jetiDecode( pPath );
+  RxJetiExPosixSerial & port = jetiDecode.GetSerial();
+
+  LoadDictionary( jetiDecode );
+  if( s_bBatch )
+    jetiDecode.SetBatch( s_batch, sizeof( s_batch ) / sizeof( s_batch[0] ) );
+  if( s_speed > 0 )
+    jetiDecode.SetClock( ReplayClock );
+  jetiDecode.Start();
+  if( !port.IsOpen() )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    exit( 1 );
+  }
+
+  uint64_t tiStart = NanoTime();
+  for( ;; )
+  {
+    RxJetiExPacket * pPacket = jetiDecode.GetPacket();
+    if( pPacket )
+      OnPacket( pPacket, NULL );
+    else if( port.IsEof() )
+      break;
+  }
+  uint64_t tiElapsed = NanoTime() - tiStart;
+  #ifdef RXJETIEX_STATS
+  PrintStats( jetiDecode.GetStats() );
+  #endif
+  #ifdef RXJETIEX_LATEST
+  if( s_bLatest )
+    PrintLatest( jetiDecode );
+  #endif
+  SaveDictionary( jetiDecode );
+  return tiElapsed;
+}
+
+// push whole capture from memory in DMA sized blocks
+static uint64_t ReplayFeed( const char * pPath )
+{
+  FILE * fp = pPath ? fopen( pPath, "rb" ) : stdin;
+  if( fp == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    exit( 1 );
+  }
+
+  size_t     nAlloc = 1 << 16;
+  size_t     nWords = 0;
+  uint16_t * pWords = (uint16_t *)malloc( nAlloc * sizeof( uint16_t ) );
+  size_t     n;
+  while( ( n = fread( &pWords[ nWords ], sizeof( uint16_t ), nAlloc - nWords, fp ) ) > 0 )
+  {
+    nWords += n;
+    if( nWords == nAlloc )
+      pWords = (uint16_t *)realloc( pWords, ( nAlloc *= 2 ) * sizeof( uint16_t ) );
+  }
+  if( fp != stdin )
+    fclose( fp );
+
+  RxJetiDecode jetiDecode;
+  LoadDictionary( jetiDecode );
+  if( s_bBatch )
+    jetiDecode.SetBatch( s_batch, sizeof( s_batch ) / sizeof( s_batch[0] ) );
+  if( s_speed > 0 )
+    jetiDecode.SetClock( ReplayClock );
+  jetiDecode.SetPacketCallback( OnPacket );
+
+  const size_t BLOCK = 64;
+  uint64_t tiStart = NanoTime();
+  for( size_t i = 0; i < nWords; i += BLOCK )
+    jetiDecode.Feed( &pWords[ i ], nWords - i < BLOCK ? nWords - i : BLOCK );
+  uint64_t tiElapsed = NanoTime() - tiStart;
+  #ifdef RXJETIEX_STATS
+  PrintStats( jetiDecode.GetStats() );
+  #endif
+  #ifdef RXJETIEX_LATEST
+  if( s_bLatest )
+    PrintLatest( jetiDecode );
+  #endif
+  SaveDictionary( jetiDecode );
+
+  free( pWords );
+  return tiElapsed;
+}
+
+int main( int argc, char * argv[] )
+{
+  bool         bFeed   = false;
+  bool         bStatic = false;
+  const char * pPath = NULL;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-q" ) == 0 )
+      s_bQuiet = true;
+    else if( strcmp( argv[i], "-l" ) == 0 )
+      s_bLatest = true;
+    else if( strcmp( argv[i], "-d" ) == 0 && i + 1 < argc )
+      s_pDictPath = argv[ ++i ];
+    else if( strcmp( argv[i], "-f" ) == 0 )
+      bFeed = true;
+    else if( strcmp( argv[i], "-t" ) == 0 )
+      bStatic = true;
+    else if( strcmp( argv[i], "-b" ) == 0 )
+      s_bBatch = true;
+    else if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+      s_speed = atof( argv[ ++i ] );
+    else
+      pPath = argv[i];
+  }
+
+  s_tiClock = NanoTime();
+  uint32_t * nPackets  = s_nPackets;
+  uint64_t   tiElapsed = bFeed ? ReplayFeed( pPath ) : bStatic ? ReplayStatic( pPath ) : ReplayPort( pPath );
+  uint32_t nTotal    = 0;
+  for( int i = 0; i < 8; i++ )
+    nTotal += nPackets[ i ];
+
+  fprintf( stderr, "packets: %u (name %u, label %u, value %u, alarm %u, text %u, error %u)\n", nTotal,
+           nPackets[ RxJetiExPacket::PACKET_NAME ], nPackets[ RxJetiExPacket::PACKET_LABEL ], nPackets[ RxJetiExPacket::PACKET_VALUE ],
+           nPackets[ RxJetiExPacket::PACKET_ALARM ], nPackets[ RxJetiExPacket::PACKET_TEXT ], nPackets[ RxJetiExPacket::PACKET_ERROR ] );
+  fprintf( stderr, "elapsed: %.3f ms, %.1f ns per packet\n", tiElapsed / 1e6, nTotal ? (double)tiElapsed / nTotal : 0.0 );
+
+  return 0;
+}
@@ -0,0 +1,129 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExResync - host tool, measures how many packets are recovered by frame resync
+                   when characters are lost (i.e. at long range)
+                   
+                   usage: RxJetiExResync [-s seed] [-r rate%] [capture file]  (stdin if omitted)
+                          -s  seed of the random character loss, default 1
+                          -r  single loss rate in percent, default: series 0.1 .. 5 %
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+**************************************************************/
+
+#include <stdlib.h>
+#include "RxJetiExDecode.h"
+
+struct Count
+{
+  uint32_t nGood;   // name, label, value, alarm and text packets
+  uint32_t nError;
+};
+
+static void OnPacket( RxJetiExPacket * pPacket, void * pContext )
+{
+  Count * pCount = (Count *)pContext;
+  if( pPacket->GetPacketType() == RxJetiExPacket::PACKET_ERROR )
+    pCount->nError++;
+  else
+    pCount->nGood++;
+}
+
+static Count Decode( const uint16_t * pWords, size_t nWords, bool bResync )
+{
+  static RxJetiDecode jetiDecode; // same dictionary for all runs, only framing is measured
+  Count count = { 0, 0 };
+
+  jetiDecode.ResetState();
+  jetiDecode.SetResync( bResync );
+  jetiDecode.SetPacketCallback( OnPacket, &count );
+  jetiDecode.Feed( pWords, nWords );
+  return count;
+}
+
+// drop characters with given probability, deterministic
+static size_t Drop( const uint16_t * pIn, size_t nWords, uint16_t * pOut, double rate, uint32_t seed )
+{
+  uint32_t state = seed;
+  uint32_t limit = (uint32_t)( rate * 4294967295.0 );
+  size_t   n     = 0;
+  for( size_t i = 0; i < nWords; i++ )
+  {
+    state = state * 1664525 + 1013904223; // LCG
+    if( state >= limit )
+      pOut[ n++ ] = pIn[ i ];
+  }
+  return n;
+}
+
+int main( int argc, char * argv[] )
+{
+  const char * pPath = NULL;
+  uint32_t     seed  = 1;
+  double       rate  = -1;
+
+  for( int i = 1; i < argc; i++ )
+  {
+    if( strcmp( argv[i], "-s" ) == 0 && i + 1 < argc )
+      seed = atoi( argv[ ++i ] );
+    else if( strcmp( argv[i], "-r" ) == 0 && i + 1 < argc )
+      rate = atof( argv[ ++i ] ) / 100.0;
+    else
+      pPath = argv[i];
+  }
+
+  FILE * fp = pPath ? fopen( pPath, "rb" ) : stdin;
+  if( fp == NULL )
+  {
+    fprintf( stderr, "cannot open %s\n", pPath );
+    return 1;
+  }
+  size_t     nAlloc = 1 << 16;
+  size_t     nWords = 0;
+  uint16_t * pWords = (uint16_t *)malloc( nAlloc * sizeof( uint16_t ) );
+  size_t     n;
+  while( ( n = fread( &pWords[ nWords ], sizeof( uint16_t ), nAlloc - nWords, fp ) ) > 0 )
+  {
+    nWords += n;
+    if( nWords == nAlloc )
+      pWords = (uint16_t *)realloc( pWords, ( nAlloc *= 2 ) * sizeof( uint16_t ) );
+  }
+  if( fp != stdin )
+    fclose( fp );
+
+  Count clean = Decode( pWords, nWords, false );
+  if( clean.nGood == 0 )
+  {
+    fprintf( stderr, "no packets in %s\n", pPath ? pPath : "stdin" );
+    free( pWords );
+    return 1;
+  }
+  uint16_t * pLossy = (uint16_t *)malloc( nWords * sizeof( uint16_t ) );
+
+  static const double rates[] = { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05 };
+  size_t nRates = rate >= 0 ? 1 : sizeof( rates ) / sizeof( rates[ 0 ] );
+
+  printf( "clean: %u packets\n", clean.nGood );
+  printf( "loss %%   packets (no resync)   packets (resync)   recovered\n" );
+  for( size_t r = 0; r < nRates; r++ )
+  {
+    double lossRate = rate >= 0 ? rate : rates[ r ];
+    size_t nLossy   = Drop( pWords, nWords, pLossy, lossRate, seed );
+    Count  plain    = Decode( pLossy, nLossy, false );
+    Count  resync   = Decode( pLossy, nLossy, true );
+    uint32_t nLost  = clean.nGood > plain.nGood ? clean.nGood - plain.nGood : 0;
+    printf( "%6.2f   %8u %6.2f%%      %8u %6.2f%%    %6.2f%% of lost\n", lossRate * 100,
+            plain.nGood,  100.0 * plain.nGood / clean.nGood,
+            resync.nGood, 100.0 * resync.nGood / clean.nGood,
+            nLost ? 100.0 * ( (double)resync.nGood - plain.nGood ) / nLost : 0.0 );
+  }
+
+  free( pLossy );
+  free( pWords );
+  return 0;
+}
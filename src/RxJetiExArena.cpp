@@ -0,0 +1,53 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExArena - fixed size bump allocator for the sensor dictionary
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+
+#include "RxJetiExArena.h"
+
+void * RxJetiExArena::Alloc( size_t size, size_t align )
+{
+  size_t pad = ( align - ( (uintptr_t)( m_pBuf + m_used ) & ( align - 1 ) ) ) & ( align - 1 );
+  if( m_used + pad + size <= m_size )
+  {
+    void * p = m_pBuf + m_used + pad;
+    m_used  += pad + size;
+    return p;
+  }
+
+  if( m_nFailed != 0xFFFF )
+    m_nFailed++;
+
+#ifdef RXJETIEX_ARENA_OOM_HEAP
+  return malloc( size );
+#else
+  return NULL;
+#endif
+}
@@ -0,0 +1,72 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExArena - fixed size bump allocator for the sensor dictionary
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXARENA_H
+#define RXJETIEXARENA_H
+
+// #define RXJETIEX_ARENA_OOM_HEAP // arena exhausted: allocate from heap instead of dropping the record
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+// Names, labels and their strings are never freed one by one, so a bump allocator 
+// on a static buffer gives deterministic memory use without heap fragmentation.
+// The buffer is provided by the owner.
+class RxJetiExArena
+{
+public:
+  enum { ALIGN = alignof( void * ) > alignof( uint32_t ) ? alignof( void * ) : alignof( uint32_t ) }; // alignment of records
+
+  RxJetiExArena() : m_pBuf( 0 ), m_size( 0 ), m_used( 0 ), m_nFailed( 0 ) {}
+
+  void   Init( uint8_t * pBuf, size_t size ){ m_pBuf = pBuf; m_size = size; Reset(); }
+  void   Reset(){ m_used = 0; } // frees everything at once
+
+  void * Alloc( size_t size, size_t align = 1 ); // NULL if exhausted (unless RXJETIEX_ARENA_OOM_HEAP)
+
+  size_t   GetUsed(){ return m_used; }
+  size_t   GetSize(){ return m_size; }
+  uint16_t GetFailed(){ return m_nFailed; } // number of allocations that did not fit
+
+protected:
+  uint8_t * m_pBuf;
+  size_t    m_size;
+  size_t    m_used;
+  uint16_t  m_nFailed;
+};
+
+// record allocation: new( arena ) RxJetiExPacketName, returns NULL if arena is exhausted
+inline void * operator new( size_t size, RxJetiExArena & arena ) noexcept { return arena.Alloc( size, RxJetiExArena::ALIGN ); }
+
+#endif // RXJETIEXARENA_H
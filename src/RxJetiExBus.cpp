@@ -0,0 +1,244 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExBus - Jeti EX Bus decoder: servo channels, telemetry and JetiBox (125/250 kbaud)
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExBus.h"
+
+// embedded EX telemetry is fed to the EX decoder as 0x7E separator + data bytes with 9th bit set
+static const uint16_t c_exSeparator = 0x007E;
+static const uint8_t  c_exBit9[ RXJETIEX_BUS_FRAME_MAX / 8 ] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+size_t RxJetiExBusDecode::Feed( const uint8_t * pData, size_t nBytes )
+{
+  m_nExPackets = 0;
+  size_t nPackets = 0;
+  for( size_t i = 0; i < nBytes; i++ )
+  {
+    RXJETIEX_STATS_INC( nBytes );
+    nPackets += Emit( DecodeByte( pData[ i ] ) );
+  }
+  return nPackets + m_nExPackets;
+}
+
+void RxJetiExBusDecode::ResetState()
+{
+  m_state  = WAIT_HEADER;
+  m_nBytes = 0;
+  #ifndef RXJETIEX_NO_RESYNC
+  m_replayIdx = m_replayEnd = 0;
+  #endif
+}
+
+// callback for a decoded packet, then bytes of a damaged frame
+size_t RxJetiExBusDecode::Emit( RxJetiExPacket * pPacket )
+{
+  size_t nPackets = 0;
+  for( ;; )
+  {
+    if( pPacket )
+    {
+      nPackets++;
+      if( m_pCallback )
+        m_pCallback( pPacket, m_pContext );
+    }
+
+    uint8_t c;
+    if( !NextReplay( &c ) )
+      break;
+    pPacket = DecodeByte( c );
+  }
+  return nPackets;
+}
+
+RxJetiExPacket * RxJetiExBusDecode::DecodeByte( uint8_t c )
+{
+  switch( m_state )
+  {
+  case WAIT_HEADER:
+    if( IsHeader( c ) )
+    {
+      m_frame[ 0 ] = c;
+      m_nBytes     = 1;
+      m_state      = WAIT_HEADER2;
+    }
+    break;
+
+  case WAIT_HEADER2:
+    if( c == 0x01 )
+    {
+      m_frame[ m_nBytes++ ] = c;
+      m_state = WAIT_LEN;
+    }
+    else if( IsHeader( c ) )
+      m_frame[ 0 ] = c; // header repeated
+    else
+      m_state = WAIT_HEADER;
+    break;
+
+  case WAIT_LEN:
+    m_frame[ m_nBytes++ ] = c;
+    if( c < 8 || c > RXJETIEX_BUS_FRAME_MAX ) // header, packet id, data id, data length, crc
+      return Error( RxJetiExPacketError::ERROR_LENGTH );
+    m_nLen  = c;
+    m_crc   = RxJetiExCrc::Crc16Update( RxJetiExCrc::Crc16Update( RxJetiExCrc::Crc16Update( 0, m_frame[ 0 ] ), m_frame[ 1 ] ), c );
+    m_state = WAIT_ENDOFFRAME;
+    break;
+
+  case WAIT_ENDOFFRAME:
+    m_frame[ m_nBytes++ ] = c;
+    if( m_nBytes <= m_nLen - 2 )
+      m_crc = RxJetiExCrc::Crc16Update( m_crc, c );
+    else if( m_nBytes == m_nLen )
+    {
+      if( m_crc != ( m_frame[ m_nLen - 2 ] | ( (uint16_t)c << 8 ) ) )
+        return Error( RxJetiExPacketError::ERROR_CRC );
+      m_state = WAIT_HEADER;
+      return DecodeFrame();
+    }
+    break;
+  }
+  return NULL;
+}
+
+// drop current frame
+RxJetiExPacket * RxJetiExBusDecode::Error( uint8_t reason )
+{
+  #ifdef RXJETIEX_STATS
+  if( reason == RxJetiExPacketError::ERROR_CRC )
+    m_stats.nCrcErrors++;
+  else
+    m_stats.nLenErrors++;
+  #endif
+  m_state          = WAIT_HEADER;
+  m_error.m_reason = reason;
+  #ifndef RXJETIEX_NO_RESYNC
+  Resync();
+  #endif
+  return &m_error;
+}
+
+#ifndef RXJETIEX_NO_RESYNC
+// a header inside the damaged frame (i.e. after a lost byte) is the begin of the next frame:
+// replay from there, followed by bytes not yet replayed
+void RxJetiExBusDecode::Resync()
+{
+  uint8_t idx = 1;
+  while( idx < m_nBytes && !IsHeader( m_frame[ idx ] ) )
+    idx++;
+
+  // frame is never ahead of replay position
+  uint8_t nSuffix  = m_nBytes - idx;
+  uint8_t nPending = m_replayEnd - m_replayIdx;
+  memmove( m_frame, &m_frame[ idx ], nSuffix );
+  memmove( &m_frame[ nSuffix ], &m_frame[ m_replayIdx ], nPending );
+  m_replayIdx = 0;
+  m_replayEnd = nSuffix + nPending;
+  m_nBytes    = 0;
+
+  #ifdef RXJETIEX_STATS
+  if( nSuffix )
+    m_stats.nResyncs++;
+  #endif
+}
+#endif
+
+// frame with valid crc
+RxJetiExPacket * RxJetiExBusDecode::DecodeFrame()
+{
+  uint8_t nData = m_frame[ 5 ];
+  if( nData + 8 != m_nLen )
+  {
+    RXJETIEX_STATS_INC( nLenErrors );
+    m_error.m_reason = RxJetiExPacketError::ERROR_LENGTH;
+    return &m_error;
+  }
+
+  switch( m_frame[ 4 ] )
+  {
+  case RXJETIEX_BUS_CHANNEL:
+    {
+      const uint8_t * pData = &m_frame[ 6 ];
+      uint8_t nChannels = min( nData / 2, RXJETIEX_BUS_CHANNELS );
+      for( uint8_t i = 0; i < nChannels; i++, pData += 2 )
+        m_channels.m_channels[ i ] = pData[ 0 ] | ( (uint16_t)pData[ 1 ] << 8 );
+      m_channels.m_nChannels = nChannels;
+      m_channels.m_packetId  = m_frame[ 3 ];
+      RXJETIEX_STATS_INC( nChannels );
+      return &m_channels;
+    }
+  case RXJETIEX_BUS_TELEMETRY:
+    return DecodeTelemetry();
+  case RXJETIEX_BUS_JETIBOX:
+    return DecodeJetiBox();
+  }
+
+  RXJETIEX_STATS_INC( nTypeErrors );
+  m_error.m_reason = RxJetiExPacketError::ERROR_TYPE;
+  return &m_error;
+}
+
+// EX frame without 0x7E separator: ex type, length, serial id, ..., crc8
+RxJetiExPacket * RxJetiExBusDecode::DecodeTelemetry()
+{
+  if( m_frame[ 0 ] != RXJETIEX_BUS_ANSWER )
+  {
+    RXJETIEX_STATS_INC( nRequests );
+    return NULL;
+  }
+
+  RXJETIEX_STATS_INC( nTelemetry );
+  if( m_pExDecode && m_frame[ 5 ] )
+  {
+    m_nExPackets += m_pExDecode->Feed( &c_exSeparator, 1 );
+    m_nExPackets += m_pExDecode->Feed( &m_frame[ 6 ], c_exBit9, m_frame[ 5 ] );
+  }
+  return NULL;
+}
+
+// receiver: button state of the transmitter, device: 32 characters JetiBox text
+RxJetiExPacket * RxJetiExBusDecode::DecodeJetiBox()
+{
+  uint8_t nData = m_frame[ 5 ];
+  if( m_frame[ 0 ] != RXJETIEX_BUS_ANSWER )
+  {
+    RXJETIEX_STATS_INC( nRequests );
+    if( nData == 0 )
+      return NULL;
+    m_jetiBox.m_packetId = m_frame[ 3 ];
+    m_jetiBox.m_buttons  = m_frame[ 6 ];
+    return &m_jetiBox;
+  }
+
+  RXJETIEX_STATS_INC( nJetiBox );
+  nData = min( nData, 32 );
+  memcpy( m_text.m_textBuffer, &m_frame[ 6 ], nData );
+  m_text.m_textBuffer[ nData ] = '\0';
+  return &m_text;
+}
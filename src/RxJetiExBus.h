@@ -0,0 +1,205 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExBus - Jeti EX Bus decoder: servo channels, telemetry and JetiBox (125/250 kbaud)
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXBUS_H
+#define RXJETIEXBUS_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+#include "RxJetiExDecode.h"
+
+#ifndef RXJETIEX_BUS_CHANNELS
+  #if defined (__AVR__)
+    #define RXJETIEX_BUS_CHANNELS 16 // max. servo channels kept per channel frame, further channels are ignored
+  #else
+    #define RXJETIEX_BUS_CHANNELS 24
+  #endif
+#endif
+#define RXJETIEX_BUS_FRAME_MAX 64   // max. EX Bus frame length incl. header and crc
+
+// EX Bus frame: header (0x3E/0x3D from receiver, 0x3B from device), 0x01, frame length, packet id,
+// data id, data length, data, crc16 (little endian) over all bytes before
+#define RXJETIEX_BUS_HEADER      0x3E // receiver, no answer
+#define RXJETIEX_BUS_REQUEST     0x3D // receiver, device may answer
+#define RXJETIEX_BUS_ANSWER      0x3B // device
+#define RXJETIEX_BUS_CHANNEL     0x31 // data id: servo channels
+#define RXJETIEX_BUS_TELEMETRY   0x3A // data id: telemetry request / EX telemetry frame
+#define RXJETIEX_BUS_JETIBOX     0x3B // data id: JetiBox request / JetiBox text
+
+// servo channels of a channel frame
+class RxJetiExPacketChannels : public RxJetiExPacket
+{
+  friend class RxJetiExBusDecode;
+public:
+  RxJetiExPacketChannels() : m_packetId( 0 ), m_nChannels( 0 ) { m_packetType = PACKET_CHANNELS; }
+
+  uint8_t  GetPacketId(){ return m_packetId; }
+  uint8_t  GetCount(){ return m_nChannels; }
+  uint16_t GetRaw( uint8_t idx ){ return idx < m_nChannels ? m_channels[ idx ] : 0; }  // 1/8 us
+  uint16_t GetMicros( uint8_t idx ){ return GetRaw( idx ) >> 3; }                      // pulse width in us, 1500 = center
+
+protected:
+  uint8_t  m_packetId;
+  uint8_t  m_nChannels;
+  uint16_t m_channels[ RXJETIEX_BUS_CHANNELS ];
+};
+
+// JetiBox request of the receiver with the button state of the transmitter
+class RxJetiExPacketJetiBox : public RxJetiExPacket
+{
+  friend class RxJetiExBusDecode;
+public:
+  RxJetiExPacketJetiBox() : m_packetId( 0 ), m_buttons( 0xF0 ) { m_packetType = PACKET_JETIBOX; }
+
+  enum enButton
+  {
+    BUTTON_RIGHT = 0x10,
+    BUTTON_UP    = 0x20,
+    BUTTON_DOWN  = 0x40,
+    BUTTON_LEFT  = 0x80,
+  };
+
+  uint8_t GetPacketId(){ return m_packetId; }
+  uint8_t GetButtons(){ return (uint8_t)( ~m_buttons & 0xF0 ); } // pressed buttons, enButton bits (low active on the bus)
+
+protected:
+  uint8_t m_packetId;
+  uint8_t m_buttons;
+};
+
+#ifdef RXJETIEX_STATS
+  struct RxJetiExBusStats
+  {
+    uint32_t nBytes;        // bytes received
+    uint32_t nChannels;     // channel frames
+    uint32_t nTelemetry;    // telemetry frames of devices
+    uint32_t nRequests;     // telemetry and JetiBox requests of the receiver
+    uint32_t nJetiBox;      // JetiBox text frames of devices
+    uint16_t nCrcErrors;    // frames with invalid crc16
+    uint16_t nLenErrors;    // frames with invalid length
+    uint16_t nTypeErrors;   // unknown data id
+    uint16_t nResyncs;      // damaged frames with a header inside, decoding resumed from there
+  };
+#endif
+
+// Byte stream decoder of an EX Bus, i.e. a sniffer on the receiver bus (8N1, 125000 or 250000 baud).
+// A frame is decoded with its last crc byte, channels don't wait for the gap after the frame.
+// Embedded EX telemetry frames are forwarded to an EX decoder, which emits names, labels and values
+// to its own callback and subscriptions, as with the 9600 baud EX stream.
+//
+// Usage:
+//   RxJetiDecode      exDecode;  // telemetry dictionary
+//   RxJetiExBusDecode busDecode( &exDecode );
+//   busDecode.SetPacketCallback( OnPacket );
+//   exDecode.SetPacketCallback( OnPacket );
+//   ...
+//   busDecode.Feed( buf, n ); // bytes received from the UART
+class RxJetiExBusDecode
+{
+public:
+  RxJetiExBusDecode( RxJetiDecodeBase * pExDecode = NULL ) : m_pExDecode( pExDecode ), m_nExPackets( 0 ), m_state( WAIT_HEADER ), m_nBytes( 0 ), m_nLen( 0 ), m_crc( 0 ),
+                                                             m_pCallback( 0 ), m_pContext( 0 )
+  {
+    #ifndef RXJETIEX_NO_RESYNC
+    m_replayIdx = 0;
+    m_replayEnd = 0;
+    #endif
+    ResetStats();
+  }
+
+  void   SetExDecoder( RxJetiDecodeBase * pExDecode ){ m_pExDecode = pExDecode; } // NULL = telemetry frames are dropped
+  void   SetPacketCallback( RxJetiExPacketCallback pCallback, void * pContext = NULL ){ m_pCallback = pCallback; m_pContext = pContext; }
+  size_t Feed( const uint8_t * pData, size_t nBytes ); // returns number of emitted packets, incl. telemetry packets of the EX decoder
+  void   ResetState();                                  // i.e. after a gap in the pushed data
+
+  // last channel frame, valid until next Feed()
+  RxJetiExPacketChannels * GetChannels(){ return &m_channels; }
+
+  #ifdef RXJETIEX_STATS
+  const RxJetiExBusStats & GetStats(){ return m_stats; }
+  void ResetStats(){ memset( &m_stats, 0, sizeof( m_stats ) ); }
+  #else
+  void ResetStats(){}
+  #endif
+
+protected:
+  enum enBusState
+  {
+    WAIT_HEADER = 0,
+    WAIT_HEADER2,
+    WAIT_LEN,
+    WAIT_ENDOFFRAME,
+  };
+
+  static bool IsHeader( uint8_t c ){ return c == RXJETIEX_BUS_HEADER || c == RXJETIEX_BUS_REQUEST || c == RXJETIEX_BUS_ANSWER; }
+
+  RxJetiExPacket * DecodeByte( uint8_t c );
+  RxJetiExPacket * DecodeFrame();
+  RxJetiExPacket * DecodeTelemetry();
+  RxJetiExPacket * DecodeJetiBox();
+  RxJetiExPacket * Error( uint8_t reason );
+  size_t           Emit( RxJetiExPacket * pPacket );
+
+  RxJetiDecodeBase * m_pExDecode;
+  size_t             m_nExPackets; // emitted by EX decoder during current Feed()
+
+  uint8_t  m_state;
+  uint8_t  m_frame[ RXJETIEX_BUS_FRAME_MAX ]; // current frame, also replay source after an error
+  uint8_t  m_nBytes;
+  uint8_t  m_nLen;                            // frame length from header
+  uint16_t m_crc;                             // running crc16 of current frame
+
+  #ifndef RXJETIEX_NO_RESYNC
+  uint8_t  m_replayIdx;
+  uint8_t  m_replayEnd;
+  bool NextReplay( uint8_t * pc ){ if( m_replayIdx >= m_replayEnd ) return false; *pc = m_frame[ m_replayIdx++ ]; return true; }
+  void Resync();
+  #else
+  bool NextReplay( uint8_t * /* pc */ ){ return false; }
+  #endif
+
+  RxJetiExPacketCallback m_pCallback;
+  void *                 m_pContext;
+
+  RxJetiExPacketChannels m_channels;
+  RxJetiExPacketJetiBox  m_jetiBox;
+  RxJetiPacketText       m_text;
+  RxJetiExPacketError    m_error;
+  #ifdef RXJETIEX_STATS
+  RxJetiExBusStats       m_stats;
+  #endif
+};
+
+#endif // RXJETIEXBUS_H
@@ -0,0 +1,79 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCrc - CRC8 for Jeti EX frames
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExCrc.h"
+
+// Published in "JETI Telemetry Protocol EN V1.06"
+uint8_t RxJetiExCrc::Crc8UpdateBitwise( uint8_t crc, uint8_t c )
+{
+  const int POLY = 7;
+  unsigned char crc_u;
+  unsigned char i;
+  crc_u = crc;
+  crc_u ^= c;
+  for (i=0; i<8; i++)
+    crc_u = ( crc_u & 0x80 ) ? POLY ^ ( crc_u << 1 ) : ( crc_u << 1 );
+  return (crc_u);
+}
+
+// Published in "JETI EX Bus protocol EN V1.21"
+uint16_t RxJetiExCrc::Crc16UpdateBitwise( uint16_t crc, uint8_t c )
+{
+  uint16_t ret_val;
+  c ^= (uint8_t)( crc ) & (uint8_t)( 0xFF );
+  c ^= c << 4;
+  ret_val = ( ( ( (uint16_t)c << 8 ) | ( ( crc & 0xFF00 ) >> 8 ) ) ^ (uint8_t)( c >> 4 ) ^ ( (uint16_t)c << 3 ) );
+  return ret_val;
+}
+
+#ifndef RXJETIEX_CRC_BITWISE
+
+#define CRC8_1( n )   RxJetiExCrc::Crc8Bits( (n), 8 )
+#define CRC8_4( n )   CRC8_1( n ),  CRC8_1( n + 1 ),  CRC8_1( n + 2 ),  CRC8_1( n + 3 )
+#define CRC8_16( n )  CRC8_4( n ),  CRC8_4( n + 4 ),  CRC8_4( n + 8 ),  CRC8_4( n + 12 )
+#define CRC8_64( n )  CRC8_16( n ), CRC8_16( n + 16 ), CRC8_16( n + 32 ), CRC8_16( n + 48 )
+
+const uint8_t RxJetiExCrc::m_crc8Table[ 256 ] RXJETIEX_PROGMEM = 
+{
+  CRC8_64( 0 ), CRC8_64( 64 ), CRC8_64( 128 ), CRC8_64( 192 )
+};
+
+#define CRC16_1( n )   RxJetiExCrc::Crc16Bits( (n), 8 )
+#define CRC16_4( n )   CRC16_1( n ),  CRC16_1( n + 1 ),  CRC16_1( n + 2 ),  CRC16_1( n + 3 )
+#define CRC16_16( n )  CRC16_4( n ),  CRC16_4( n + 4 ),  CRC16_4( n + 8 ),  CRC16_4( n + 12 )
+#define CRC16_64( n )  CRC16_16( n ), CRC16_16( n + 16 ), CRC16_16( n + 32 ), CRC16_16( n + 48 )
+
+const uint16_t RxJetiExCrc::m_crc16Table[ 256 ] RXJETIEX_PROGMEM = 
+{
+  CRC16_64( 0 ), CRC16_64( 64 ), CRC16_64( 128 ), CRC16_64( 192 )
+};
+
+#endif // RXJETIEX_CRC_BITWISE
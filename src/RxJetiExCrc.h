@@ -0,0 +1,88 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCrc - CRC8 for Jeti EX frames, CRC16 for EX Bus frames
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXCRC_H
+#define RXJETIEXCRC_H
+
+// #define RXJETIEX_CRC_BITWISE // bit loop instead of lookup tables (256 + 512 bytes), saves flash but costs ~8 branches per byte
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+#include "RxJetiExFlash.h"
+
+class RxJetiExCrc
+{
+public:
+  // Jeti EX Protocol: 8-bit CRC polynomial X^8 + X^2 + X + 1
+  static inline uint8_t Crc8Update( uint8_t crc, uint8_t c )
+  {
+  #ifdef RXJETIEX_CRC_BITWISE
+    return Crc8UpdateBitwise( crc, c );
+  #else
+    return RXJETIEX_READ_BYTE( &m_crc8Table[ (uint8_t)( crc ^ c ) ] );
+  #endif
+  }
+
+  static uint8_t Crc8UpdateBitwise( uint8_t crc, uint8_t c );
+
+  // Jeti EX Bus: CRC16-CCITT X^16 + X^12 + X^5 + 1, reflected (0x8408), init 0
+  static inline uint16_t Crc16Update( uint16_t crc, uint8_t c )
+  {
+  #ifdef RXJETIEX_CRC_BITWISE
+    return Crc16UpdateBitwise( crc, c );
+  #else
+    return ( crc >> 8 ) ^ RXJETIEX_READ_WORD( &m_crc16Table[ (uint8_t)( crc ^ c ) ] );
+  #endif
+  }
+
+  static uint16_t Crc16UpdateBitwise( uint16_t crc, uint8_t c );
+
+  // compile time table generation (C++11 constexpr)
+  static constexpr uint8_t Crc8Bits( uint8_t crc, int nBits )
+  {
+    return nBits == 0 ? crc : Crc8Bits( ( crc & 0x80 ) ? (uint8_t)( ( crc << 1 ) ^ 0x07 ) : (uint8_t)( crc << 1 ), nBits - 1 );
+  }
+  static constexpr uint16_t Crc16Bits( uint16_t crc, int nBits )
+  {
+    return nBits == 0 ? crc : Crc16Bits( ( crc & 0x0001 ) ? (uint16_t)( ( crc >> 1 ) ^ 0x8408 ) : (uint16_t)( crc >> 1 ), nBits - 1 );
+  }
+
+#ifndef RXJETIEX_CRC_BITWISE
+  static const uint8_t  m_crc8Table[ 256 ];  // in flash (PROGMEM) on AVR
+  static const uint16_t m_crc16Table[ 256 ];
+#endif
+};
+
+#endif // RXJETIEXCRC_H
@@ -0,0 +1,133 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCrypt - legacy EX frame decryption with cached keystreams
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExCrypt.h"
+
+RxJetiExCrypt::RxJetiExCrypt()
+{
+  for( uint8_t i = 0; i < RXJETIEX_CRYPT_CACHE; i++ )
+  {
+    m_cache[ i ].key = 0;
+    m_cache[ i ].age = i;
+  }
+}
+
+void RxJetiExCrypt::Decrypt( uint8_t * pBuf, uint8_t nPacketLen )
+{
+  const uint8_t o = 5; // serial id and key are not encrypted
+  if( pBuf[ 4 ] == 0 || nPacketLen <= o + 1 || nPacketLen > RXJETIEX_CRYPT_LEN )
+    return;
+  Xor( pBuf + o, GetKeystream( pBuf[ 4 ], nPacketLen ) + o, nPacketLen - 1 - o );
+}
+
+const uint8_t * RxJetiExCrypt::GetKeystream( uint8_t key, uint8_t nPacketLen )
+{
+  uint8_t     lenBit = nPacketLen & 0x02;
+  Keystream * pHit   = NULL;
+  Keystream * pOld   = &m_cache[ 0 ];
+
+  for( uint8_t i = 0; i < RXJETIEX_CRYPT_CACHE; i++ )
+  {
+    Keystream * p = &m_cache[ i ];
+    if( p->key == key && p->lenBit == lenBit )
+    {
+      pHit = p;
+      break;
+    }
+    if( p->age > pOld->age )
+      pOld = p;
+  }
+
+  if( pHit == NULL )
+  {
+    // miss: derive whole keystream once
+    pHit         = pOld;
+    pHit->key    = key;
+    pHit->lenBit = lenBit;
+    for( uint8_t idx = 0; idx < RXJETIEX_CRYPT_LEN; idx++ )
+      pHit->mask[ idx ] = Mask( key, idx, nPacketLen );
+  }
+
+  // age all entries younger than the hit
+  for( uint8_t i = 0; i < RXJETIEX_CRYPT_CACHE; i++ )
+    if( m_cache[ i ].age < pHit->age )
+      m_cache[ i ].age++;
+  pHit->age = 0;
+
+  return pHit->mask;
+}
+
+void RxJetiExCrypt::Xor( uint8_t * pDst, const uint8_t * pMask, uint8_t n )
+{
+#if !defined (__AVR__)
+  // 4 bytes at once, memcpy is alignment safe and compiles to plain loads
+  for( ; n >= 4; n -= 4, pDst += 4, pMask += 4 )
+  {
+    uint32_t d, m;
+    memcpy( &d, pDst, 4 );
+    memcpy( &m, pMask, 4 );
+    d ^= m;
+    memcpy( pDst, &d, 4 );
+  }
+#endif
+  while( n-- )
+    *pDst++ ^= *pMask++;
+}
+
+//
+// ********************** taken from Jeti-Duplex-EX code by H.Stoecklein ******************
+//
+// xor mask of legacy encryption for ex buffer index idx (frame bytes 0-2 are omitted in buffer)
+uint8_t RxJetiExCrypt::Mask( uint8_t key, uint8_t idx, uint8_t nPacketLen )
+{
+  static const uint8_t cryptcode[4] = { 0x52,0x1C,0x6C,0x23 };
+  const int o = 3; // buffer offset since bytes 0-2 are omitted
+  uint8_t mask;
+
+  if( key == 0 || idx < 8-o ) // not encrypted
+    return 0;
+
+  if( idx == 8-o ) // telemetry value id
+  {
+    mask = key ^ 0x6D;
+    if (!(nPacketLen & 0x02))         // something fishy at Byte 8...
+      mask ^= 0x3F;
+    return mask;
+  }
+
+  uint8_t i = idx + o; // decode frame starting at byte 9
+  mask = key ^ (cryptcode[i%4] + ((i%2)?((i-8)&0xFC):0));
+  if( key & 0x02 )
+    mask ^= 0x3F;
+  if( idx == 9-o )
+    mask ^= 32;         // Roberts Tipp (tnx!)
+  return mask;
+}
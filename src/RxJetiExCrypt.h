@@ -0,0 +1,79 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExCrypt - legacy EX frame decryption with cached keystreams
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXCRYPT_H
+#define RXJETIEXCRYPT_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+#ifndef RXJETIEX_CRYPT_CACHE
+  #if defined (__AVR__)
+    #define RXJETIEX_CRYPT_CACHE 1  // number of cached keystreams (34 bytes each)
+  #else
+    #define RXJETIEX_CRYPT_CACHE 4
+  #endif
+#endif
+
+#define RXJETIEX_CRYPT_LEN 32 // size of EX buffer
+
+class RxJetiExCrypt
+{
+public:
+  RxJetiExCrypt();
+
+  // decrypt EX buffer in place (frame bytes 0-2 omitted, key at offset 4, crc at nPacketLen-1 not encrypted)
+  void Decrypt( uint8_t * pBuf, uint8_t nPacketLen );
+
+  // keystream of key, least recently used entry is replaced on a miss
+  const uint8_t * GetKeystream( uint8_t key, uint8_t nPacketLen );
+
+  // xor mask of legacy encryption for ex buffer index idx
+  static uint8_t Mask( uint8_t key, uint8_t idx, uint8_t nPacketLen );
+
+  // pDst ^= pMask, word wise except on AVR
+  static void Xor( uint8_t * pDst, const uint8_t * pMask, uint8_t n );
+
+protected:
+  struct Keystream
+  {
+    uint8_t key;     // 0 = unused
+    uint8_t lenBit;  // bit 1 of packet length changes the mask of the value id byte
+    uint8_t age;     // 0 = most recently used
+    uint8_t mask[ RXJETIEX_CRYPT_LEN ];
+  };
+  Keystream m_cache[ RXJETIEX_CRYPT_CACHE ];
+};
+
+#endif // RXJETIEXCRYPT_H
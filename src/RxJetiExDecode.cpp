@@ -38,30 +38,297 @@ void  RxJetiDecode::Start( enComPort comPort )
   m_pSerial->Init(); 
 }
 
-RxJetiExPacket * RxJetiDecode::GetPacket()
+void  RxJetiDecode::Start( RxJetiExSerial * pSerial )
 {
-  if( millis() > m_tiTimeout )
+  m_pSerial = pSerial;
+  m_pSerial->Init(); 
+}
+
+// next value of current EX data frame
+RxJetiExPacket * RxJetiDecodeBase::NextValue()
+{
+  #ifdef RXJETIEX_STATS_TIMING
+  uint32_t tiStart = micros();
+  #endif
+
+  RxJetiExPacket * pPacket;
+  if( m_batch.m_pRecords ) // continuation of a full batch
   {
-    m_tiTimeout = millis() + 1000;
-    m_state = WAIT_STARTOFPACKET; 
-    return NULL;
+    m_state = WAIT_STARTOFPACKET;
+    pPacket = DecodeBatch();
+    if( m_batch.m_nRecords == 0 )
+      pPacket = NULL;
   }
-  
-  // process existing ex buffer witch values
-  if( m_state == WAIT_NEXTVALUE )
+  else
   {
-    RxJetiExPacket * pPacket = DecodeValue();
+    pPacket = DecodeValue();
     if( pPacket == NULL )
       m_state = WAIT_STARTOFPACKET; 
-    return pPacket;
   }
 
-  // process next character
-  uint16_t c =  m_pSerial->Getchar();
+  #ifdef RXJETIEX_STATS_TIMING
+  TimeFrame( tiStart );
+  #endif
+  return pPacket;
+}
+
+#ifdef RXJETIEX_STATS_TIMING
+RxJetiExPacket * RxJetiDecodeBase::ProcessChar( uint16_t c )
+{
+  m_stats.nBytes++;
+  uint32_t tiStart = micros();
+  RxJetiExPacket * pPacket = DecodeChar( c );
+  TimeFrame( tiStart );
+  return pPacket;
+}
+
+// sum up decode time from start of frame until all values are delivered
+void RxJetiDecodeBase::TimeFrame( uint32_t tiStart )
+{
+  if( m_state != WAIT_STARTOFPACKET )
+  {
+    if( !m_bTiming )
+      m_tiFrame = 0;
+    m_bTiming = true;
+  }
+  if( !m_bTiming )
+    return;
+
+  m_tiFrame += micros() - tiStart;
+  if( m_state == WAIT_STARTOFPACKET )
+  {
+    m_bTiming = false;
+    if( m_tiFrame < m_stats.tiMin ) m_stats.tiMin = m_tiFrame;
+    if( m_tiFrame > m_stats.tiMax ) m_stats.tiMax = m_tiFrame;
+    m_stats.tiSum += m_tiFrame;
+    m_stats.nTimed++;
+  }
+}
+#endif
+
+#ifdef RXJETIEX_STATS
+void RxJetiDecodeBase::ResetStats()
+{
+  memset( &m_stats, 0, sizeof( m_stats ) );
+  #ifdef RXJETIEX_STATS_TIMING
+  m_stats.tiMin = 0xFFFFFFFF;
+  m_bTiming     = false;
+  m_tiFrame     = 0;
+  #endif
+}
+#endif
+
+void RxJetiDecodeBase::ResetState()
+{
+  #ifdef RXJETIEX_STATS
+  if( m_state != WAIT_STARTOFPACKET )
+    RXJETIEX_STATS_INC( nTimeouts ); // incomplete frame
+  #endif
+  m_state = WAIT_STARTOFPACKET;
+  #ifndef RXJETIEX_NO_RESYNC
+  m_replayIdx = m_replayEnd = 0; // old data
+  #endif
+}
+
+// no character available: drop an incomplete frame after the inter-byte timeout, flag a lost link after the inter-frame timeout
+void RxJetiDecodeBase::CheckTimeout()
+{
+  uint32_t tiElapsed = m_tiNow - m_tiLast;
+  if( m_state != WAIT_STARTOFPACKET )
+  {
+    if( tiElapsed >= m_tiByteTimeout )
+      ResetState(); // time between frames counts from last character
+  }
+  else if( tiElapsed >= m_tiFrameTimeout && !m_bLinkLost )
+  {
+    m_bLinkLost = true; // until next character
+    RXJETIEX_STATS_INC( nLinkLost );
+  }
+}
+
+// drop current frame
+RxJetiExPacket * RxJetiDecodeBase::Error( uint8_t reason )
+{
+  m_state          = WAIT_STARTOFPACKET;
+  m_error.m_reason = reason;
+  #ifndef RXJETIEX_NO_RESYNC
+  if( m_bResync )
+    Resync();
+  #endif
+  return &m_error;
+}
+
+#ifndef RXJETIEX_NO_RESYNC
+// a start marker inside the damaged frame (i.e. after a lost character) is the begin of the next frame:
+// replay from there, followed by characters not yet replayed
+void RxJetiDecodeBase::Resync()
+{
+  uint8_t idx = 1;
+  while( idx < m_nHist && m_hist[ idx ] != 0x007E && m_hist[ idx ] != 0x00FE )
+    idx++;
+
+  // history is never ahead of replay position
+  uint8_t nSuffix  = m_nHist - idx;
+  uint8_t nPending = m_replayEnd - m_replayIdx;
+  memmove( m_hist, &m_hist[ idx ], nSuffix * sizeof( uint16_t ) );
+  memmove( &m_hist[ nSuffix ], &m_hist[ m_replayIdx ], nPending * sizeof( uint16_t ) );
+  m_replayIdx = 0;
+  m_replayEnd = nSuffix + nPending;
+  m_nHist     = 0;
+
+  #ifdef RXJETIEX_STATS
+  if( nSuffix )
+    m_stats.nResyncs++;
+  #endif
+}
+#endif
+
+size_t RxJetiDecodeBase::Feed( const uint16_t * pWords, size_t nWords )
+{
+  m_tiNow = m_pClock();
+  size_t nPackets = EmitPackets( NULL ); // values left over from GetPacket()
+  for( size_t i = 0; i < nWords; i++ )
+    nPackets += EmitPackets( ProcessChar( pWords[ i ] ) );
+  return nPackets;
+}
+
+size_t RxJetiDecodeBase::Feed( const uint8_t * pData, const uint8_t * pBit9, size_t nBytes )
+{
+  m_tiNow = m_pClock();
+  size_t nPackets = EmitPackets( NULL );
+  for( size_t i = 0; i < nBytes; i++ )
+  {
+    uint16_t c = pData[ i ];
+    if( pBit9[ i >> 3 ] & ( 1 << ( i & 0x07 ) ) )
+      c |= 0x0100;
+    nPackets += EmitPackets( ProcessChar( c ) );
+  }
+  return nPackets;
+}
+
+// hand packet and all following values of an EX data frame to callback
+size_t RxJetiDecodeBase::EmitPackets( RxJetiExPacket * pPacket )
+{
+  size_t nPackets = 0;
+  for( ;; )
+  {
+    if( pPacket )
+    {
+      nPackets++;
+      CallHandlers( pPacket );
+      if( m_pCallback )
+        m_pCallback( pPacket, m_pContext );
+    }
+
+    uint16_t c;
+    if( m_state == WAIT_NEXTVALUE )
+      pPacket = NextValue();
+    else if( NextReplay( &c ) ) // characters of a damaged frame
+      pPacket = ProcessChar( c );
+    else
+      break;
+  }
+  return nPackets;
+}
+
+// subscriptions
+////////////////
+void RxJetiDecodeBase::SubscribeType( uint8_t packetType, RxJetiExPacketCallback pHandler, void * pContext )
+{
+  if( packetType > RxJetiExPacket::PACKET_BATCH )
+    return;
+  m_typeHandlers[ packetType ].pHandler = pHandler;
+  m_typeHandlers[ packetType ].pContext = pContext;
+
+  m_bTypeHandlers = false;
+  for( uint8_t i = 0; i <= RxJetiExPacket::PACKET_BATCH; i++ )
+    if( m_typeHandlers[ i ].pHandler )
+      m_bTypeHandlers = true;
+}
+
+#if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+bool RxJetiDecodeBase::Subscribe( uint32_t serialId, uint8_t id, RxJetiExValueHandler pHandler, void * pContext )
+{
+  if( pHandler == NULL || id == 0 )
+    return false;
+
+  // replace existing or take first free entry
+  uint8_t idx = FindSubscription( serialId, id );
+  for( uint8_t i = 0; idx == 0 && i < RXJETIEX_MAX_SUBSCRIPTIONS; i++ )
+    if( m_subs[ i ].id == 0 )
+      idx = i + 1;
+  if( idx == 0 )
+    return false;
+
+  Subscription * pSub = &m_subs[ idx - 1 ];
+  pSub->serialId = serialId;
+  pSub->id       = id;
+  pSub->pHandler = pHandler;
+  pSub->pContext = pContext;
+  if( idx > m_nSubs )
+    m_nSubs = idx;
+
+  // label already known: resolve now
+  RxJetiExPacketLabel * pLabel = FindLabel( serialId, id );
+  if( pLabel )
+    pLabel->m_subIdx = idx;
+  return true;
+}
+
+void RxJetiDecodeBase::Unsubscribe( uint32_t serialId, uint8_t id )
+{
+  uint8_t idx = FindSubscription( serialId, id );
+  if( idx == 0 )
+    return;
+
+  memset( &m_subs[ idx - 1 ], 0, sizeof( Subscription ) );
+  while( m_nSubs && m_subs[ m_nSubs - 1 ].id == 0 )
+    m_nSubs--;
+
+  RxJetiExPacketLabel * pLabel = FindLabel( serialId, id );
+  if( pLabel )
+    pLabel->m_subIdx = 0;
+}
+
+uint8_t RxJetiDecodeBase::FindSubscription( uint32_t serialId, uint8_t id )
+{
+  for( uint8_t i = 0; i < m_nSubs; i++ )
+    if( m_subs[ i ].id == id && m_subs[ i ].serialId == serialId )
+      return i + 1;
+  return 0;
+}
+#endif
+
+void RxJetiDecodeBase::CallHandlers( RxJetiExPacket * pPacket )
+{
+  uint8_t packetType = pPacket->GetPacketType();
+  if( m_bTypeHandlers && packetType <= RxJetiExPacket::PACKET_BATCH && m_typeHandlers[ packetType ].pHandler )
+    m_typeHandlers[ packetType ].pHandler( pPacket, m_typeHandlers[ packetType ].pContext );
+
+  #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+  if( packetType == RxJetiExPacket::PACKET_VALUE && m_nSubs )
+  {
+    // resolved at label creation, linear search for values without label only
+    RxJetiExPacketValue * pValue = (RxJetiExPacketValue *)pPacket;
+    uint8_t idx = pValue->m_pLabel ? pValue->m_pLabel->m_subIdx : FindSubscription( pValue->m_serialId, pValue->m_id );
+    if( idx )
+      m_subs[ idx - 1 ].pHandler( pValue, m_subs[ idx - 1 ].pContext );
+  }
+  #endif
+}
+
+// run state machine with next character
+RxJetiExPacket * RxJetiDecodeBase::DecodeChar( uint16_t c )
+{
   if( c )
   {
-    m_tiTimeout = millis() + 1000;
-    
+    #ifndef RXJETIEX_NO_RESYNC
+    if( m_state == WAIT_STARTOFPACKET )
+      m_nHist = 0;
+    if( m_nHist < RXJETIEX_RESYNC_SIZE )
+      m_hist[ m_nHist++ ] = c;
+    #endif
+
     // DumpSerial( 1, c );
     // char buf[32];
     // sprintf( buf, "0x%x\n", c ); Serial.print( buf );
@@ -96,16 +363,17 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
       else
       {
         // Serial.println( "Unhandled packet type" ); 
-        m_state = WAIT_STARTOFPACKET; // unhandled message
-        return &m_error;
+        RXJETIEX_STATS_INC( nTypeErrors );
+        return Error( RxJetiExPacketError::ERROR_TYPE ); // unhandled message
       }
     }
     else if( m_state == WAIT_LEN )
     {
-      m_enMsgType  = (((uint8_t)c >> 6) & 0x03);
+      m_enMsgType  = (enMsgType)(((uint8_t)c >> 6) & 0x03);
       m_nPacketLen = (uint8_t)c & 0x1F;
       m_nBytes     = 0;
-      memset( m_exBuffer, 0, sizeof( m_exBuffer ) );
+      m_crc        = RxJetiExCrc::Crc8Update( 0, m_nPacketLen | (m_enMsgType << 6) );
+      m_pKeystream = NULL;
 
      // char buf[32];
      // sprintf( buf, "msgytpe: %d\n", m_enMsgType ); Serial.print( buf );
@@ -116,8 +384,8 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
       }
       else
       {
-        m_state = WAIT_STARTOFPACKET; // invalid length
-        return &m_error;
+        RXJETIEX_STATS_INC( nLenErrors );
+        return Error( RxJetiExPacketError::ERROR_LENGTH ); // invalid length
       }
 
       // Serial.print( "Packet len: " ); 
@@ -125,14 +393,28 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
     }
     else if( m_state == WAIT_ENDOFEXPACKET )
     {
-      m_exBuffer[ m_nBytes++ ] = (uint8_t)c;
-        
-      if( m_nBytes == m_nPacketLen )
+      // crc and decryption byte by byte, crc is calculated from encrypted data
+      if( m_nBytes < m_nPacketLen - 1 )
       {
-        if( crcCheck() )
+        uint8_t b = (uint8_t)c;
+        m_crc = RxJetiExCrc::Crc8Update( m_crc, b );
+        if( m_pKeystream )
+          b ^= m_pKeystream[ m_nBytes ];
+        else if( m_nBytes == 4 && b != 0 && m_nPacketLen <= RXJETIEX_CRYPT_LEN ) // key is not encrypted, fetch its cached keystream once
+          m_pKeystream = m_crypt.GetKeystream( b, m_nPacketLen );
+        m_exBuffer[ m_nBytes++ ] = b;
+      }
+      else
+      {
+        m_exBuffer[ m_nBytes++ ] = (uint8_t)c;
+
+        if( m_crc == (uint8_t)c )
         {
-          uint8_t key = m_exBuffer[4];          
-          decrypt( key, m_exBuffer, m_nPacketLen );
+          #ifdef RXJETIEX_STATS
+          if( m_enMsgType == MSGTYPE_TEXT ) m_stats.nExText++;
+          else if( m_enMsgType == MSGTYPE_MSG ) m_stats.nExMsg++;
+          else m_stats.nExData++;
+          #endif
 
           // DumpBuffer( m_exBuffer, m_nPacketLen );
 
@@ -152,16 +434,24 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
           else if( m_enMsgType == MSGTYPE_MSG )
           {
             // todo
-            memcpy( &m_value.m_serialId, &m_exBuffer[0], 4 );
-            m_nBytes = 5; // place index on first value
+            BeginValues();
+            if( m_batch.m_pRecords )
+            {
+              m_state = WAIT_STARTOFPACKET;
+              return DecodeBatch();
+            }
             m_state = WAIT_NEXTVALUE;
             return NULL; 
           }
           else
           {
             // DumpBuffer( m_exBuffer, m_nPacketLen );
-            memcpy( &m_value.m_serialId, &m_exBuffer[0], 4 );
-            m_nBytes = 5; // place index on first value
+            BeginValues();
+            if( m_batch.m_pRecords )
+            {
+              m_state = WAIT_STARTOFPACKET;
+              return DecodeBatch();
+            }
             m_state = WAIT_NEXTVALUE;
             return DecodeValue();
           }
@@ -170,8 +460,8 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
         {
           // invalid crc
           // Serial.println( "Crc error" ); 
-          m_state = WAIT_STARTOFPACKET;
-          return &m_error;
+          RXJETIEX_STATS_INC( nCrcErrors );
+          return Error( RxJetiExPacketError::ERROR_CRC );
         }
       }
     }
@@ -182,6 +472,7 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
       {
          m_alarm.m_bSound = m_exBuffer[ 0 ] & 1;
          m_alarm.m_code   = m_exBuffer[ 1 ];
+         RXJETIEX_STATS_INC( nAlarm );
          m_state = WAIT_STARTOFPACKET; 
          return &m_alarm;
       }
@@ -193,12 +484,13 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
          m_state = WAIT_STARTOFPACKET; 
          memcpy( &m_text.m_textBuffer, &m_exBuffer[0], m_nBytes );
          m_text.m_textBuffer[m_nBytes] = '\0';
+         RXJETIEX_STATS_INC( nText );
          return &m_text;
       }
-      else if( m_nBytes > 32 )
+      else if( m_nBytes >= sizeof( m_text.m_textBuffer ) - 1 )
       {
-        m_state = WAIT_STARTOFPACKET; // invalid length
-        return &m_error;
+        RXJETIEX_STATS_INC( nLenErrors );
+        return Error( RxJetiExPacketError::ERROR_TEXT ); // invalid length
       }
       else
         m_exBuffer[ m_nBytes++ ] = (uint8_t)c;
@@ -208,7 +500,7 @@ RxJetiExPacket * RxJetiDecode::GetPacket()
   return NULL;
 }
 
-RxJetiExPacket * RxJetiDecode::DecodeName()
+RxJetiExPacket * RxJetiDecodeBase::DecodeName()
 {
    uint32_t serialId;
    memcpy( &serialId, &m_exBuffer[0], 4 );
@@ -216,31 +508,21 @@ RxJetiExPacket * RxJetiDecode::DecodeName()
   if( m_nPacketLen < 8 ) 
     return NULL;
 
-   // already present
-   RxJetiExPacketName * pName = FindName( serialId );
-   if( pName )
-   {
-     if( pName->m_pstrName == NULL ) // dummy name element, generated by AppendLabel ?
-       pName->m_pstrName = NewName();
-     return pName;
-   }
-
-   // new sensor
-   pName = new RxJetiExPacketName;
-   pName->m_serialId = serialId;
-
-  // get sensor name
-  pName->m_pstrName = NewName();
-
-  // append to list
-  AppendName( pName );
+  // new sensor or already present
+  RxJetiExPacketName * pName = AddName( serialId );
+  if( pName == NULL )
+    return NULL; // dictionary full
 
-  DumpOutput( pName );
+  if( pName->m_pstrName == NULL ) // new or dummy name element, generated by AppendLabel ?
+  {
+    pName->m_pstrName = NewName();
+    DumpOutput( pName );
+  }
 
   return pName;
 }
 
-RxJetiExPacket * RxJetiDecode::DecodeLabel()
+RxJetiExPacket * RxJetiDecodeBase::DecodeLabel()
 {
   uint32_t serialId;
   memcpy( &serialId, &m_exBuffer[0], 4 );
@@ -255,7 +537,9 @@ RxJetiExPacket * RxJetiDecode::DecodeLabel()
     return pLabel;
 
   // new label
-  pLabel = new RxJetiExPacketLabel;
+  RxJetiExPacketName * pName = AddName( serialId );
+  if( pName == NULL || ( pLabel = new( m_arena ) RxJetiExPacketLabel ) == NULL )
+    return NULL; // dictionary full
   pLabel->m_serialId = serialId;
   pLabel->m_id = id;
 
@@ -264,31 +548,73 @@ RxJetiExPacket * RxJetiDecode::DecodeLabel()
   pLabel->m_pstrUnit = NewUnit();
 
   // append to list
-  AppendLabel( pLabel );
+  AppendLabel( pName, pLabel );
 
   DumpOutput( pLabel );
 
   return pLabel;
 }
 
-char * RxJetiDecode::NewName()
+// serial id of data frame, place index on first value
+void RxJetiDecodeBase::BeginValues()
+{
+  memcpy( &m_value.m_serialId, &m_exBuffer[0], 4 );
+  m_nBytes = 5;
+}
+
+// all values of current frame at once, value subscriptions are served per value
+// a full batch leaves the remaining values in WAIT_NEXTVALUE for the next batch
+RxJetiExPacket * RxJetiDecodeBase::DecodeBatch()
+{
+  m_batch.m_serialId = m_value.m_serialId;
+  m_batch.m_nRecords = 0;
+  m_batch.m_bMore    = false;
+  while( m_batch.m_nRecords < m_batch.m_nMax && DecodeValue() )
+  {
+    RxJetiExValueRecord * pRecord = &m_batch.m_pRecords[ m_batch.m_nRecords++ ];
+    pRecord->pLabel   = m_value.m_pLabel;
+    pRecord->value    = m_value.m_value;
+    pRecord->id       = m_value.m_id;
+    pRecord->exType   = m_value.m_exType;
+    pRecord->exponent = m_value.m_exponent;
+    #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+    if( m_nSubs )
+      CallHandlers( &m_value );
+    #endif
+    if( m_batch.m_nRecords == m_batch.m_nMax )
+    {
+      m_batch.m_bMore = m_nBytes + 2 <= m_nPacketLen - 1; // at least one more value fits, see DecodeValue()
+      if( m_batch.m_bMore )
+        m_state = WAIT_NEXTVALUE;
+    }
+  }
+  return &m_batch;
+}
+
+char * RxJetiDecodeBase::NewName()
 { 
   int n = 6;
   // get sensor name or label
   int len = (m_exBuffer[n] >> 3) & 0x1F;
-  char * p = new char[ len + 1 ];
+  len = min( len, m_nPacketLen - 1 - (n+1) ); // stay inside frame, crc byte excluded
+  char * p = (char *)m_arena.Alloc( len + 1 );
+  if( p == NULL )
+    return NULL;
   memcpy( p, &m_exBuffer[ n + 1 ], len );
   p[len]  = '\0';
 
   return p;
 }
 
-char * RxJetiDecode::NewUnit()
+char * RxJetiDecodeBase::NewUnit()
 {
   int n = 6;
   int len1 = (m_exBuffer[n] >> 3) & 0x1F;
   int len2 = m_exBuffer[n] & 0x07;
-  char * p = new char[ len2 + 1 ];
+  len2 = max( 0, min( len2, m_nPacketLen - 1 - (n+1) - len1 ) ); // stay inside frame, crc byte excluded
+  char * p = (char *)m_arena.Alloc( len2 + 1 );
+  if( p == NULL )
+    return NULL;
   memcpy( p, &m_exBuffer[(n+1) + len1], len2 );
   p[len2] = '\0';
 
@@ -300,20 +626,23 @@ char * RxJetiDecode::NewUnit()
   return p;
 }
 
-char * RxJetiDecode::NewString( const char * pStr )
+char * RxJetiDecodeBase::NewString( const char * pStr )
 {
   size_t l = strlen( pStr ) + 1;
-  char * c = new char[ l ];
-  strcpy( c, pStr );
-  c[l] = '\0';
+  char * c = (char *)m_arena.Alloc( l );
+  if( c )
+    memcpy( c, pStr, l );
 
   return c;
 }
 
 // decode sensor value from jeti ex format
-RxJetiExPacket * RxJetiDecode::DecodeValue()
+RxJetiExPacket * RxJetiDecodeBase::DecodeValue()
 {
-  if( m_nBytes >= m_nPacketLen - 3 ) // minimum length: packetLen - 1byte crc - 1 byte id - 1 byte data 
+  // data bytes per enDataType, 0 = invalid
+  static const uint8_t valueSize[ 16 ] = { 1, 2, 0, 0, 3, 3, 0, 0, 4, 4, 0, 0, 0, 0, 0, 0 };
+
+  if( m_nBytes + 2 > m_nPacketLen - 1 ) // minimum length: 1 byte id + 1 byte data, crc excluded
     return NULL;
 
   // type and id
@@ -322,6 +651,10 @@ RxJetiExPacket * RxJetiDecode::DecodeValue()
   if( m_value.m_id == 0 )
     m_value.m_id = m_exBuffer[ m_nBytes++ ];
 
+  uint8_t size = valueSize[ m_value.m_exType ];
+  if( size == 0 || m_nBytes + size > m_nPacketLen - 1 ) // unknown type or value truncated
+    return NULL;
+
   switch( m_value.m_exType )
   {
   case RxJetiExPacket::TYPE_6b:
@@ -392,28 +725,57 @@ RxJetiExPacket * RxJetiDecode::DecodeValue()
 
   // link value with label 
   m_value.m_pLabel = FindLabel( m_value.m_serialId, m_value.m_id );
+  #ifdef RXJETIEX_STATS
+  if( m_value.m_pLabel == NULL )
+    RXJETIEX_STATS_INC( nUnknownLabel );
+  #endif
+
+  #ifdef RXJETIEX_LATEST
+  if( m_value.m_pLabel )
+  {
+    RxJetiExLatest * pLatest = &m_value.m_pLabel->m_latest;
+    pLatest->value    = m_value.m_value;
+    pLatest->exType   = m_value.m_exType;
+    pLatest->exponent = m_value.m_exponent;
+    pLatest->tiUpdate = m_tiNow;
+    if( ++pLatest->nUpdates == 0 )
+      pLatest->nUpdates = 1; // 0 is reserved for "no value yet"
+  }
+  #endif
 
   DumpOutput( &m_value );
 
   return &m_value;
 }
 
-RxJetiExPacketName * RxJetiDecode::FindName( uint32_t serialId )
+RxJetiExPacketName * RxJetiDecodeBase::FindName( uint32_t serialId )
 {
-  RxJetiExPacketName * p = m_pSensorList;
-  while( p )
+  RxJetiExPacketName * p = (RxJetiExPacketName *)m_index.Find( serialId, 0 );
+  if( p )
+    return p;
+
+  // index overflow, walk the list
+  if( !m_index.IsComplete() )
   {
-    if( p->m_serialId == serialId )
-      return p;
-    p = p->m_pNext; 
+    p = m_pSensorList;
+    while( p )
+    {
+      if( p->m_serialId == serialId )
+        return p;
+      p = p->m_pNext; 
+    }
   }
-  return 0;
+  return FlashName( serialId );
 }
 
-RxJetiExPacketLabel * RxJetiDecode::FindLabel( uint32_t serialId, uint8_t id )
+RxJetiExPacketLabel * RxJetiDecodeBase::FindLabel( uint32_t serialId, uint8_t id )
 {
-  RxJetiExPacketLabel * pL = NULL;
-  RxJetiExPacketName  * pN = FindName( serialId );
+  RxJetiExPacketLabel * pL = (RxJetiExPacketLabel *)m_index.Find( serialId, id );
+  if( pL )
+    return pL;
+
+  // index overflow, walk the list
+  RxJetiExPacketName  * pN = m_index.IsComplete() ? NULL : FindName( serialId );
   if( pN )
   {
     pL = pN->m_pFirstLabel; 
@@ -424,87 +786,381 @@ RxJetiExPacketLabel * RxJetiDecode::FindLabel( uint32_t serialId, uint8_t id )
       pL = pL->m_pNext; 
     }
   }
-  return 0;
+  return FlashLabel( serialId, id );
 }
 
-void RxJetiDecode::AppendName( RxJetiExPacketName * pName )
+void RxJetiDecodeBase::AppendName( RxJetiExPacketName * pName )
 {
   if( m_pSensorList == NULL )
-  {
     m_pSensorList = pName;
-    return;
+  else
+    m_pLastName->m_pNext = pName;
+  m_pLastName = pName;
+
+  m_index.Insert( pName->m_serialId, 0, pName );
+}
+
+void RxJetiDecodeBase::AppendLabel( RxJetiExPacketName * pN, RxJetiExPacketLabel *pLabel )
+{
+  if( pN->m_pFirstLabel == NULL )
+    pN->m_pFirstLabel = pLabel;
+  else
+    pN->m_pLastLabel->m_pNext = pLabel;
+  pN->m_pLastLabel = pLabel;
+  pLabel->m_pName  = pN;
+
+  m_index.Insert( pLabel->m_serialId, pLabel->m_id, pLabel );
+  #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+  pLabel->m_subIdx = FindSubscription( pLabel->m_serialId, pLabel->m_id ); // resolve once
+  #endif
+}
+
+// find sensor or append a new (unnamed) one, NULL if dictionary is full
+RxJetiExPacketName * RxJetiDecodeBase::AddName( uint32_t serialId )
+{
+  RxJetiExPacketName * pN = FindName( serialId );
+  if( pN == NULL && ( pN = new( m_arena ) RxJetiExPacketName ) != NULL )
+  {
+    pN->m_serialId = serialId;
+    AppendName( pN );
   }
+  return pN;
+}
+
+// drop all sensors, names and labels
+void RxJetiDecodeBase::ResetDictionary()
+{
+  m_pSensorList    = NULL;
+  m_pLastName      = NULL;
+  m_value.m_pLabel = NULL;
+  m_index.Clear();
+  m_arena.Reset();
+}
 
-  RxJetiExPacketName * p = m_pSensorList;
-  while( p )
+// flash dictionary
+///////////////////
+#ifdef RXJETIEX_FLASH_DICT
+bool RxJetiDecodeBase::SetFlashDictionary( const RxJetiExFlashEntry * pTable, uint16_t nEntries )
+{
+  // binary search needs ascending (serialId, id)
+  m_nFlashDict = 0;
+  RxJetiExFlashEntry prev, entry;
+  for( uint16_t i = 0; i < nEntries; i++, prev = entry )
   {
-    if( p->m_pNext == NULL )
-    {
-      p->m_pNext = pName;
-      return;
-    }
-    p = p->m_pNext; 
+    RXJETIEX_MEMCPY_P( &entry, &pTable[ i ], sizeof( entry ) );
+    if( i > 0 && ( entry.serialId < prev.serialId || ( entry.serialId == prev.serialId && entry.id <= prev.id ) ) )
+      return false;
   }
-  return;
+
+  m_pFlashDict = pTable;
+  m_nFlashDict = nEntries;
+  ResetDictionary();
+  return true;
 }
 
-void RxJetiDecode::AppendLabel( RxJetiExPacketLabel *pLabel )
+// binary search of the table in flash
+bool RxJetiDecodeBase::FindFlashEntry( uint32_t serialId, uint8_t id, RxJetiExFlashEntry * pEntry )
 {
-  RxJetiExPacketLabel * pL = NULL;
-  RxJetiExPacketName  * pN = FindName( pLabel->m_serialId );
-  if( pN == NULL )
+  uint16_t lo = 0;
+  uint16_t hi = m_nFlashDict;
+  while( lo < hi )
   {
-    pN = new RxJetiExPacketName;
-    pN->m_serialId = pLabel->m_serialId;
-    AppendName( pN );
-    pN->m_pFirstLabel = pLabel;
-    pLabel->m_pName = pN;
-    return;
+    uint16_t mid = lo + ( hi - lo ) / 2;
+    RXJETIEX_MEMCPY_P( pEntry, &m_pFlashDict[ mid ], sizeof( *pEntry ) );
+    if( serialId < pEntry->serialId || ( serialId == pEntry->serialId && id < pEntry->id ) )
+      hi = mid;
+    else if( serialId == pEntry->serialId && id == pEntry->id )
+      return true;
+    else
+      lo = mid + 1;
   }
+  return false;
+}
 
-  // name found w/o finding a label before
-  if( pN->m_pFirstLabel == NULL )
+// index miss: record in RAM (index, subscriptions, latest values) for a flash entry, strings stay in flash
+RxJetiExPacketName * RxJetiDecodeBase::FlashName( uint32_t serialId )
+{
+  RxJetiExFlashEntry   entry;
+  RxJetiExPacketName * pName;
+  if( !FindFlashEntry( serialId, 0, &entry ) || ( pName = new( m_arena ) RxJetiExPacketName ) == NULL )
+    return NULL;
+  pName->m_serialId = serialId;
+  pName->m_pstrName = (char *)entry.pstrText;
+  pName->m_bFlash   = true;
+  AppendName( pName );
+  return pName;
+}
+
+RxJetiExPacketLabel * RxJetiDecodeBase::FlashLabel( uint32_t serialId, uint8_t id )
+{
+  RxJetiExFlashEntry    entry;
+  RxJetiExPacketName  * pName;
+  RxJetiExPacketLabel * pLabel;
+  if( id == 0 || !FindFlashEntry( serialId, id, &entry ) || ( pName = AddName( serialId ) ) == NULL ||
+      ( pLabel = new( m_arena ) RxJetiExPacketLabel ) == NULL )
+    return NULL;
+  pLabel->m_serialId  = serialId;
+  pLabel->m_id        = id;
+  pLabel->m_pstrLabel = (char *)entry.pstrText;
+  pLabel->m_pstrUnit  = (char *)entry.pstrUnit;
+  pLabel->m_bFlash    = true;
+  AppendLabel( pName, pLabel );
+  return pLabel;
+}
+#endif
+
+// dictionary persistence
+// blob format, integers little endian:
+//   'J' 'X' version nNames[2]
+//   per name:  serialId[4] nameLen name[] nLabels
+//   per label: id labelLen label[] unitLen unit[]
+//   crc8 of all preceding bytes
+// string length 0xFF: no string
+//////////////////////////
+static const uint8_t dictMagic[]  = { 'J', 'X' };
+static const uint8_t dictVersion  = 1;
+static const uint8_t dictNoString = 0xFF;
+
+static bool DictWrite( RxJetiExWriter & writer, uint8_t * pCrc, const void * pData, size_t nBytes )
+{
+  for( size_t i = 0; i < nBytes; i++ )
+    *pCrc = RxJetiExCrc::Crc8Update( *pCrc, ((const uint8_t *)pData)[ i ] );
+  return writer.Write( (const uint8_t *)pData, nBytes );
+}
+
+static bool DictRead( RxJetiExReader & reader, uint8_t * pCrc, void * pData, size_t nBytes )
+{
+  if( !reader.Read( (uint8_t *)pData, nBytes ) )
+    return false;
+  for( size_t i = 0; i < nBytes; i++ )
+    *pCrc = RxJetiExCrc::Crc8Update( *pCrc, ((uint8_t *)pData)[ i ] );
+  return true;
+}
+
+static bool DictWriteString( RxJetiExWriter & writer, uint8_t * pCrc, const char * pStr )
+{
+  uint8_t len = dictNoString;
+  if( pStr )
+    len = (uint8_t)min( strlen( pStr ), (size_t)dictNoString - 1 );
+  if( !DictWrite( writer, pCrc, &len, 1 ) )
+    return false;
+  return len == dictNoString || DictWrite( writer, pCrc, pStr, len );
+}
+
+static bool DictWriteSerial( RxJetiExWriter & writer, uint8_t * pCrc, uint32_t serialId )
+{
+  uint8_t buf[ 4 ] = { (uint8_t)serialId, (uint8_t)( serialId >> 8 ), (uint8_t)( serialId >> 16 ), (uint8_t)( serialId >> 24 ) };
+  return DictWrite( writer, pCrc, buf, 4 );
+}
+
+bool RxJetiDecodeBase::SaveDictionary( RxJetiExWriter & writer )
+{
+  uint16_t nNames = 0;
+  for( RxJetiExPacketName * pName = m_pSensorList; pName; pName = pName->m_pNext )
+    nNames++;
+
+  uint8_t crc = 0;
+  uint8_t header[] = { dictMagic[ 0 ], dictMagic[ 1 ], dictVersion, (uint8_t)nNames, (uint8_t)( nNames >> 8 ) };
+  if( !DictWrite( writer, &crc, header, sizeof( header ) ) )
+    return false;
+
+  for( RxJetiExPacketName * pName = m_pSensorList; pName; pName = pName->m_pNext )
   {
-    pN->m_pFirstLabel = pLabel;
-    pLabel->m_pName = pN;
-    return;
+    uint8_t nLabels = 0;
+    for( RxJetiExPacketLabel * pLabel = pName->m_pFirstLabel; pLabel && nLabels < 0xFF; pLabel = pLabel->m_pNext )
+      if( !pLabel->m_bFlash )
+        nLabels++;
+
+    // flash dictionary entries are resolved from flash again after load
+    if( !DictWriteSerial( writer, &crc, pName->m_serialId ) || !DictWriteString( writer, &crc, pName->m_bFlash ? NULL : pName->m_pstrName ) ||
+        !DictWrite( writer, &crc, &nLabels, 1 ) )
+      return false;
+
+    RxJetiExPacketLabel * pLabel = pName->m_pFirstLabel;
+    for( uint8_t i = 0; i < nLabels; i++, pLabel = pLabel->m_pNext )
+    {
+      while( pLabel->m_bFlash )
+        pLabel = pLabel->m_pNext;
+      if( !DictWrite( writer, &crc, &pLabel->m_id, 1 ) || !DictWriteString( writer, &crc, pLabel->m_pstrLabel ) ||
+          !DictWriteString( writer, &crc, pLabel->m_pstrUnit ) )
+        return false;
+    }
   }
 
-  // at least one label already exists
-  pL = pN->m_pFirstLabel; // name found w/o finding a label before
-  while( pL )
+  uint8_t crcOut = crc;
+  return writer.Write( &crcOut, 1 );
+}
+
+// string from blob into dictionary, skipped if dictionary is full
+char * RxJetiDecodeBase::ReadString( RxJetiExReader & reader, uint8_t * pCrc )
+{
+  uint8_t len;
+  if( !DictRead( reader, pCrc, &len, 1 ) || len == dictNoString )
+    return NULL;
+
+  char * p = (char *)m_arena.Alloc( len + 1 );
+  for( uint8_t i = 0; i < len; i++ )
   {
-    if( pL->m_pNext == NULL )
+    uint8_t c;
+    if( !DictRead( reader, pCrc, &c, 1 ) )
+      return NULL;
+    if( p )
+      p[ i ] = (char)c;
+  }
+  if( p )
+    p[ len ] = '\0';
+  return p;
+}
+
+bool RxJetiDecodeBase::LoadDictionary( RxJetiExReader & reader )
+{
+  ResetDictionary();
+
+  uint8_t crc = 0;
+  uint8_t header[ 5 ];
+  if( !DictRead( reader, &crc, header, sizeof( header ) ) ||
+      header[ 0 ] != dictMagic[ 0 ] || header[ 1 ] != dictMagic[ 1 ] || header[ 2 ] != dictVersion )
+    return false;
+
+  uint16_t nNames  = header[ 3 ] | ( (uint16_t)header[ 4 ] << 8 );
+  uint16_t nFailed = m_arena.GetFailed();
+  bool     bOk     = true;
+  for( uint16_t n = 0; n < nNames && bOk; n++ )
+  {
+    uint8_t buf[ 4 ];
+    bOk = DictRead( reader, &crc, buf, 4 );
+    uint32_t serialId = buf[ 0 ] | ( (uint32_t)buf[ 1 ] << 8 ) | ( (uint32_t)buf[ 2 ] << 16 ) | ( (uint32_t)buf[ 3 ] << 24 );
+
+    RxJetiExPacketName * pName = bOk ? AddName( serialId ) : NULL;
+    char * pstrName = ReadString( reader, &crc );
+    if( pName && pName->m_pstrName == NULL )
+      pName->m_pstrName = pstrName;
+
+    uint8_t nLabels = 0;
+    bOk = bOk && DictRead( reader, &crc, &nLabels, 1 );
+    for( uint8_t i = 0; i < nLabels && bOk; i++ )
     {
-      pL->m_pNext = pLabel;
-      pLabel->m_pName = pN;
-      return;
+      uint8_t id;
+      bOk = DictRead( reader, &crc, &id, 1 );
+      char * pstrLabel = ReadString( reader, &crc );
+      char * pstrUnit  = ReadString( reader, &crc );
+
+      RxJetiExPacketLabel * pLabel;
+      if( bOk && pName && FindLabel( serialId, id ) == NULL && ( pLabel = new( m_arena ) RxJetiExPacketLabel ) != NULL )
+      {
+        pLabel->m_serialId  = serialId;
+        pLabel->m_id        = id;
+        pLabel->m_pstrLabel = pstrLabel;
+        pLabel->m_pstrUnit  = pstrUnit;
+        AppendLabel( pName, pLabel );
+      }
     }
-    pL = pL->m_pNext; 
   }
-  return;
+
+  // crc covers all bytes, a damaged blob is dropped completely
+  uint8_t crcIn;
+  if( !bOk || !reader.Read( &crcIn, 1 ) || crcIn != crc )
+  {
+    ResetDictionary();
+    return false;
+  }
+  return m_arena.GetFailed() == nFailed;
+}
+
+// hash index
+/////////////
+void RxJetiExIndex::Clear()
+{
+  for( uint16_t i = 0; i <= m_mask; i++ )
+    m_pSlots[ i ] = NULL;
+  m_nUsed     = 0;
+  m_bComplete = true;
+}
+
+RxJetiExPacket * RxJetiExIndex::Find( uint32_t serialId, uint8_t id )
+{
+  uint16_t i = Hash( serialId, id ) & m_mask;
+  RxJetiExPacket * p;
+  while( ( p = m_pSlots[ i ] ) != NULL ) // linear probing, there is always a free slot
+  {
+    if( Match( p, serialId, id ) )
+      return p;
+    i = ( i + 1 ) & m_mask;
+  }
+  return NULL;
+}
+
+bool RxJetiExIndex::Insert( uint32_t serialId, uint8_t id, RxJetiExPacket * pPacket )
+{
+  if( m_nUsed >= ( ( m_mask + 1 ) >> 2 ) * 3 ) // keep load factor <= 3/4
+  {
+    m_bComplete = false;
+    return false;
+  }
+
+  uint16_t i = Hash( serialId, id ) & m_mask;
+  while( m_pSlots[ i ] != NULL )
+    i = ( i + 1 ) & m_mask;
+  m_pSlots[ i ] = pPacket;
+  m_nUsed++;
+  return true;
+}
+
+bool RxJetiExIndex::Match( RxJetiExPacket * pPacket, uint32_t serialId, uint8_t id )
+{
+  if( id == 0 )
+    return pPacket->GetPacketType() == RxJetiExPacket::PACKET_NAME && ((RxJetiExPacketName *)pPacket)->m_serialId == serialId;
+
+  RxJetiExPacketLabel * pLabel = (RxJetiExPacketLabel *)pPacket;
+  return pPacket->GetPacketType() == RxJetiExPacket::PACKET_LABEL && pLabel->m_id == id && pLabel->m_serialId == serialId;
+}
+
+#ifdef RXJETIEX_LATEST
+const RxJetiExLatest * RxJetiDecodeBase::GetLatest( uint32_t serialId, uint8_t id )
+{
+  RxJetiExPacketLabel * pLabel = FindLabel( serialId, id );
+  if( pLabel )
+    return &pLabel->m_latest;
+  return NULL;
+}
+
+bool RxJetiDecodeBase::GetLatest( uint32_t serialId, uint8_t id, RxJetiExPacketValue * pValue )
+{
+  RxJetiExPacketLabel * pLabel = FindLabel( serialId, id );
+  if( pLabel == NULL || pLabel->m_latest.nUpdates == 0 || pValue == NULL )
+    return false;
+
+  pValue->m_serialId = serialId;
+  pValue->m_id       = id;
+  pValue->m_value    = pLabel->m_latest.value;
+  pValue->m_exType   = pLabel->m_latest.exType;
+  pValue->m_exponent = pLabel->m_latest.exponent;
+  pValue->m_pLabel   = pLabel;
+  return true;
 }
+#endif
 
 // optionally add missing label, unit and name data to current value
-bool RxJetiDecode::CompleteValue( RxJetiExPacketValue * pValue, const char * pstrName, const char * pstrLabel, const char * pstrUnit )
+bool RxJetiDecodeBase::CompleteValue( RxJetiExPacketValue * pValue, const char * pstrName, const char * pstrLabel, const char * pstrUnit )
 {
   RxJetiExPacketLabel * pLabel = FindLabel( pValue->m_serialId, pValue->m_id );
   if( pLabel )
     return false; // nothing to do
   
   // new label
-  pLabel = new RxJetiExPacketLabel;
+  RxJetiExPacketName * pName = AddName( pValue->m_serialId );
+  if( pName == NULL || ( pLabel = new( m_arena ) RxJetiExPacketLabel ) == NULL )
+    return false; // dictionary full
   pLabel->m_serialId  = pValue->m_serialId;
   pLabel->m_id        = pValue->m_id;
   pLabel->m_pstrLabel = NewString( pstrLabel );
   pLabel->m_pstrUnit  = NewString( pstrUnit );
 
   // append to list
-  AppendLabel( pLabel );
+  AppendLabel( pName, pLabel );
 
   // set sensor name
-  RxJetiExPacketName * pName = FindName( pValue->m_serialId );
-  if( pName && pName->m_pstrName == NULL )
+  if( pName->m_pstrName == NULL )
     pName->m_pstrName = NewString( pstrName );
 
   return true;
@@ -517,6 +1173,34 @@ bool RxJetiDecode::CompleteValue( RxJetiExPacketValue * pValue, const char * pst
 // string for unknown name, labels and units
 const char * RxJetiExPacket::m_strUnknown = "?";
 
+#ifdef RXJETIEX_FLASH_STRINGS
+char RxJetiExPacket::m_scratch[ 3 ][ 32 ];
+
+const char * RxJetiExPacket::FlashString( const char * pStr, bool bFlash, uint8_t scratch )
+{
+  if( !bFlash )
+    return pStr;
+  strncpy_P( m_scratch[ scratch ], pStr, sizeof( m_scratch[ 0 ] ) - 1 );
+  m_scratch[ scratch ][ sizeof( m_scratch[ 0 ] ) - 1 ] = '\0';
+  return m_scratch[ scratch ];
+}
+#endif
+
+bool RxJetiExPacketBatch::GetValue( uint8_t idx, RxJetiExPacketValue * pValue )
+{
+  if( idx >= m_nRecords || pValue == NULL )
+    return false;
+
+  RxJetiExValueRecord * pRecord = &m_pRecords[ idx ];
+  pValue->m_serialId = m_serialId;
+  pValue->m_id       = pRecord->id;
+  pValue->m_value    = pRecord->value;
+  pValue->m_exType   = pRecord->exType;
+  pValue->m_exponent = pRecord->exponent;
+  pValue->m_pLabel   = pRecord->pLabel;
+  return true;
+}
+
 bool RxJetiExPacketValue::GetFloat( float * pValue )
 {
   if( IsNumeric() && pValue )
@@ -548,25 +1232,91 @@ bool  RxJetiExPacketValue::GetLongitude( float * pLongitude )
 }
 
 bool RxJetiExPacketValue::GetGPS( bool * pbLongitude, float * pCoord )
+{
+  bool     bNegative;
+  uint16_t deg16, min16;
+  if( GetGPSRaw( pbLongitude, &bNegative, &deg16, &min16 ) )
+  {
+    float frac  = min16 / 0.60000f / 100000.0f;
+    float coord = deg16 + frac;
+
+    *pCoord = bNegative ? -coord : coord;
+    return true;
+  }
+  return false;
+}
+
+// degrees and 1/1000 minutes
+bool RxJetiExPacketValue::GetGPSRaw( bool * pbLongitude, bool * pbNegative, uint16_t * pDeg, uint16_t * pMin )
 {
   if( m_exType == TYPE_GPS )
   {
     i2b.vInt = m_value;
     *pbLongitude = i2b.vBytes[3] & 0x20;
-    uint16_t deg16  = (i2b.vBytes[3] & 0x01) << 8;
-             deg16 +=  i2b.vBytes[2];
-    uint16_t min16  =  i2b.vBytes[1] << 8;
-             min16 +=  i2b.vBytes[0];
+    *pbNegative  = i2b.vBytes[3] & 0x40;
+    *pDeg  = (i2b.vBytes[3] & 0x01) << 8;
+    *pDeg +=  i2b.vBytes[2];
+    *pMin  =  i2b.vBytes[1] << 8;
+    *pMin +=  i2b.vBytes[0];
+    return true;
+  }
+  return false;
+}
 
-    float frac  = min16 / 0.60000f / 100000.0f;
-    float coord = deg16 + frac;
+bool RxJetiExPacketValue::GetGPSE7( bool * pbLongitude, int32_t * pCoord )
+{
+  bool     bNegative;
+  uint16_t deg16, min16;
+  if( GetGPSRaw( pbLongitude, &bNegative, &deg16, &min16 ) && deg16 <= 180 ) // 9 bit degrees would overflow
+  {
+    // 1/1000 minute = 1E7 / 60000 = 500/3 units of 1E-7 degrees
+    int32_t coord = (int32_t)deg16 * 10000000L + ( (uint32_t)min16 * 500 + 1 ) / 3;
+    *pCoord = bNegative ? -coord : coord;
+    return true;
+  }
+  return false;
+}
+
+bool RxJetiExPacketValue::GetLatitudeE7( int32_t * pLatitude )
+{
+  bool bLongitude;
+  return GetGPSE7( &bLongitude, pLatitude ) && !bLongitude;
+}
 
-    *pCoord = ( i2b.vBytes[3] & 0x40 ) ? -coord : coord;
+bool RxJetiExPacketValue::GetLongitudeE7( int32_t * pLongitude )
+{
+  bool bLongitude;
+  return GetGPSE7( &bLongitude, pLongitude ) && bLongitude;
+}
+
+bool RxJetiExPacketValue::GetInt( int32_t * pValue, uint8_t * pExponent )
+{
+  if( IsNumeric() && pValue && pExponent )
+  {
+    *pValue    = m_value;
+    *pExponent = m_exponent;
     return true;
   }
   return false;
 }
 
+bool RxJetiExPacketValue::GetScaled( int32_t * pValue, uint8_t exponent )
+{
+  if( !IsNumeric() || pValue == NULL )
+    return false;
+
+  int32_t value = m_value;
+  for( uint8_t e = m_exponent; e < exponent; e++ ) // more decimals: caller picks an exponent the range fits in
+    value *= 10;
+  if( m_exponent > exponent )                        // less decimals: round half away from zero
+  {
+    int32_t div = m_exponent - exponent == 1 ? 10 : 100;
+    value = value >= 0 ? ( value + div / 2 ) / div : ( value - div / 2 ) / div;
+  }
+  *pValue = value;
+  return true;
+}
+
 bool RxJetiExPacketValue::GetDate( uint8_t * pDay, uint8_t * pMonth, uint16_t * pYear )
 {
   if( m_exType == TYPE_DT )
@@ -583,6 +1333,16 @@ bool RxJetiExPacketValue::GetDate( uint8_t * pDay, uint8_t * pMonth, uint16_t *
   return false;
 }
 
+bool RxJetiExPacketValue::GetDate( RxJetiExDate * pDate )
+{
+  return pDate && GetDate( &pDate->day, &pDate->month, &pDate->year );
+}
+
+bool RxJetiExPacketValue::GetTime( RxJetiExTime * pTime )
+{
+  return pTime && GetTime( &pTime->hour, &pTime->minute, &pTime->second );
+}
+
 bool RxJetiExPacketValue::GetTime( uint8_t * pHour, uint8_t * pMinute, uint8_t * pSecond )
 {
   if( m_exType == TYPE_DT )
@@ -617,71 +1377,10 @@ bool RxJetiExPacketValue::IsValueComplete()
 }
 
 
-// Jeti helpers
-///////////////
-
-// Published in "JETI Telemetry Protocol EN V1.06"
-//* Jeti EX Protocol: Calculate 8-bit CRC polynomial X^8 + X^2 + X + 1
-uint8_t RxJetiDecode::update_crc (uint8_t crc, uint8_t crc_seed)
-{
-  const int POLY = 7;
-  unsigned char crc_u;
-  unsigned char i;
-  crc_u = crc;
-  crc_u ^= crc_seed;
-  for (i=0; i<8; i++)
-    crc_u = ( crc_u & 0x80 ) ? POLY ^ ( crc_u << 1 ) : ( crc_u << 1 );
-  return (crc_u);
-}
-
-//* Calculate CRC8 Checksum over EX-Frame, Original code by Jeti
-bool RxJetiDecode::crcCheck()
-{
-  uint8_t crc = 0;
-  uint8_t c;
-
-  uint8_t lenByte = m_nPacketLen | (m_enMsgType << 6);
-  crc = update_crc( lenByte, crc );
-
-  for( c = 0; c < m_nPacketLen - 1; c++ )
-    crc = update_crc( m_exBuffer[c], crc );
-
-  // Serial.print( "crc: " ); Serial.print( crc ); Serial.print( "/" ); Serial.println( m_exBuffer[ m_nPacketLen-1 ] );
-
-  return( crc == m_exBuffer[ m_nPacketLen - 1] );
-}
-
-//
-// ********************** taken from Jeti-Duplex-EX code by H.Stoecklein ******************
-//
-// Prepare EX data frame for transfer (Frameheader, Crypting, Länge, CRC)
-void RxJetiDecode::decrypt( uint8_t key, uint8_t * exbuf, unsigned char n )
-{
-  unsigned char i;
-  uint8_t cryptcode[4] = { 0x52,0x1C,0x6C,0x23 };
-  int o = 3; // buffer offset since bytes 0-2 are omitted
-
-  if( key == 0 ) // not encrypted
-    return;
-
-  exbuf[8-o] = exbuf[8-o] ^ key ^ 0x6D; // telemetry value id
-  if (!(m_nPacketLen & 0x02))       // something fishy at Byte 8...
-    exbuf[8-o]^=0x3F;
-
-  exbuf[9-o] ^= 32;         // Roberts Tipp (tnx!)
-
-  for( i = 9; i < n+o; i++ ) // Now decode frame starting at byte 9
-  {
-    exbuf[i-o] = exbuf[i-o] ^ key ^ (cryptcode[i%4] + ((i%2)?((i-8)&0xFC):0));
-    if( key & 0x02 )
-      exbuf[i-o] ^= 0x3F;
-  }
-}
-
 // Debug output
 ///////////////
 #ifdef RXJETIEX_DECODE_DEBUG
-void RxJetiDecode::DumpOutput( RxJetiExPacket * pPacket )
+void RxJetiDecodeBase::DumpOutput( RxJetiExPacket * pPacket )
 {
   char buf[50];
   RxJetiExPacketName  * pName  = NULL;
@@ -714,7 +1413,7 @@ void RxJetiDecode::DumpOutput( RxJetiExPacket * pPacket )
   }
 }
 
-void RxJetiDecode::DumpBuffer( uint8_t * buffer, uint8_t nChars )
+void RxJetiDecodeBase::DumpBuffer( uint8_t * buffer, uint8_t nChars )
 {
   Serial.println( "Buffer Dump" ); 
   for( int i = 0; i < nChars; i++ )
@@ -725,7 +1424,7 @@ void RxJetiDecode::DumpBuffer( uint8_t * buffer, uint8_t nChars )
   Serial.println( "" );
 }
 
-void RxJetiDecode::DumpSerial( int numChar, uint16_t sChar, bool bLf  )
+void RxJetiDecodeBase::DumpSerial( int numChar, uint16_t sChar, bool bLf  )
 {
    char buf[ 64 ];
    int idx = 0;
@@ -761,7 +1460,7 @@ void RxJetiDecode::DumpSerial( int numChar, uint16_t sChar, bool bLf  )
      Serial.print( buf );
 }
 
-const char * RxJetiDecode::GetDataTypeString( uint8_t dataType )
+const char * RxJetiDecodeBase::GetDataTypeString( uint8_t dataType )
 {
   static const char * typeBuf[] = { "6b", "14b", "?", "?", "22b", "DT", "?", "?", "30b", "GPS" };
   return typeBuf[ dataType < 10 ? dataType : 2 ];
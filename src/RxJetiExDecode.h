@@ -41,6 +41,89 @@
 #endif
 
 #include "RxJetiExSerial.h"
+#include "RxJetiExFlash.h"
+#include "RxJetiExCrc.h"
+#include "RxJetiExCrypt.h"
+#include "RxJetiExArena.h"
+#include "RxJetiExStream.h"
+
+#ifndef RXJETIEX_READ_CHUNK
+  #define RXJETIEX_READ_CHUNK  16 // characters fetched from serial port at once
+#endif
+#ifndef RXJETIEX_INDEX_SIZE
+  #if defined (__AVR__)
+    #define RXJETIEX_INDEX_SIZE  64 // name and label hash index slots (power of two), max. 3/4 are used
+  #else
+    #define RXJETIEX_INDEX_SIZE 256
+  #endif
+#endif
+#ifndef RXJETIEX_ARENA_SIZE
+  #if defined (__AVR__)
+    #define RXJETIEX_ARENA_SIZE  768 // bytes for sensor names, labels and units
+  #else
+    #define RXJETIEX_ARENA_SIZE 8192
+  #endif
+#endif
+#ifndef RXJETIEX_MAX_SUBSCRIPTIONS
+  #if defined (__AVR__)
+    #define RXJETIEX_MAX_SUBSCRIPTIONS 4 // value handlers per (serialId, id), 0 = no subscription API
+  #else
+    #define RXJETIEX_MAX_SUBSCRIPTIONS 16
+  #endif
+#endif
+#ifndef RXJETIEX_BYTE_BUDGET
+  #define RXJETIEX_BYTE_BUDGET 32 // default max. characters processed per GetPacket() call
+#endif
+#ifndef RXJETIEX_BYTE_TIMEOUT
+  #define RXJETIEX_BYTE_TIMEOUT 20     // default ms without a character inside a frame until the frame is dropped
+#endif
+#ifndef RXJETIEX_FRAME_TIMEOUT
+  #define RXJETIEX_FRAME_TIMEOUT 1000  // default ms without a character between frames until the link counts as lost
+#endif
+
+// #define RXJETIEX_STATS        // decoder statistics, GetStats()
+// #define RXJETIEX_STATS_TIMING // decode time per frame in micros(), implies RXJETIEX_STATS
+#if defined( RXJETIEX_STATS_TIMING ) && !defined( RXJETIEX_STATS )
+  #define RXJETIEX_STATS
+#endif
+
+// #define RXJETIEX_LATEST       // keep last value of each label, GetLatest()
+// #define RXJETIEX_NO_RESYNC    // no rescan of a damaged frame for the next start marker, saves 2 * RXJETIEX_RESYNC_SIZE bytes RAM
+#ifndef RXJETIEX_RESYNC_SIZE
+  #define RXJETIEX_RESYNC_SIZE 36 // raw characters of current frame kept for resync, max. frame is 34
+#endif
+
+#ifdef RXJETIEX_STATS
+  #define RXJETIEX_STATS_INC( counter ) m_stats.counter++
+
+  struct RxJetiDecodeStats
+  {
+    uint32_t nBytes;        // characters received
+    uint32_t nExText;       // EX name and label frames
+    uint32_t nExData;       // EX data frames
+    uint32_t nExMsg;        // EX message frames
+    uint32_t nAlarm;        // alarm frames
+    uint32_t nText;         // simple text frames
+    uint16_t nCrcErrors;    // EX frames with invalid crc
+    uint16_t nLenErrors;    // EX or text frames with invalid length
+    uint16_t nTypeErrors;   // unhandled frame type
+    uint16_t nTimeouts;     // incomplete frames dropped after timeout or ResetState()
+    uint16_t nLinkLost;     // no character for the inter-frame timeout
+    uint16_t nResyncs;      // damaged frames with a start marker inside, decoding resumed from there
+    uint16_t nUnknownLabel; // values without label
+    uint16_t nOverflows;    // receive buffer overruns, from serial port
+    uint8_t  highWater;     // max. receive buffer fill level, from serial port
+  #ifdef RXJETIEX_STATS_TIMING
+    uint32_t tiMin;         // decode time per frame [us]
+    uint32_t tiMax;
+    uint32_t tiSum;
+    uint32_t nTimed;        // number of timed frames
+    uint32_t GetAvg() const { return nTimed ? tiSum / nTimed : 0; }
+  #endif
+  };
+#else
+  #define RXJETIEX_STATS_INC( counter )
+#endif
 
 class RxJetiExPacket
 {
@@ -56,8 +139,11 @@ public:
     PACKET_ALARM = 4,
     PACKET_ERROR = 5,
     PACKET_TEXT  = 6,
-  }
-  EN_PACKET_TYPE;
+    PACKET_BATCH = 7, // all values of an EX data frame, see RxJetiDecodeBase::SetBatch()
+    PACKET_CHANNELS = 8, // EX Bus servo channels, see RxJetiExBusDecode
+    PACKET_JETIBOX  = 9, // EX Bus JetiBox request (buttons)
+  };
+  typedef enPacketType EN_PACKET_TYPE; // type only, no storage in dictionary records
 
   // Jeti data types
   enum enDataType
@@ -68,27 +154,46 @@ public:
     TYPE_DT   = 5, // int22_t Special data type � time and date
     TYPE_30b  = 8, // int30_t Data type 30b (-536870911 �536870911) 
     TYPE_GPS  = 9, // int30_t Special data type � GPS coordinates:  lo/hi minute - lo/hi degree. 
-  }
-  EN_DATA_TYPE;
+  };
+  typedef enDataType EN_DATA_TYPE;
 
   uint8_t GetPacketType(){ return m_packetType; } // enPacketType
 
 protected: 
   uint8_t m_packetType; // enPacketType
 
-  union
-  {
-    uint32_t vInt;
-    uint8_t  vBytes[4];
-  } i2b; // integer to bytes and vice versa
-
   static const char * m_strUnknown; // "?"
+
+  // strings from flash dictionary are copied to a scratch buffer per kind (AVR), valid until next call of the same kind
+  enum { SCRATCH_NAME = 0, SCRATCH_LABEL = 1, SCRATCH_UNIT = 2 };
+  #ifdef RXJETIEX_FLASH_STRINGS
+  static const char * FlashString( const char * pStr, bool bFlash, uint8_t scratch );
+  static char m_scratch[ 3 ][ 32 ];
+  #else
+  static const char * FlashString( const char * pStr, bool /* bFlash */, uint8_t /* scratch */ ){ return pStr; }
+  #endif
 };
 
 class RxJetiExPacketError : public RxJetiExPacket
 {
+  friend class RxJetiDecodeBase;
+  friend class RxJetiExBusDecode;
 public:
-  RxJetiExPacketError() { m_packetType = PACKET_ERROR; }
+  RxJetiExPacketError() : m_reason( ERROR_NONE ) { m_packetType = PACKET_ERROR; }
+
+  enum enErrorReason
+  {
+    ERROR_NONE      = 0,
+    ERROR_TYPE      = 1, // unhandled frame type
+    ERROR_LENGTH    = 2, // invalid EX frame length
+    ERROR_CRC       = 3, // invalid EX frame crc
+    ERROR_TEXT      = 4, // text frame too long
+  };
+
+  uint8_t GetReason(){ return m_reason; } // enErrorReason
+
+protected:
+  uint8_t m_reason;
 };
 
 class RxJetiExPacketLabel;
@@ -96,48 +201,132 @@ class RxJetiExPacketName : public RxJetiExPacket
 {
   friend class RxJetiExPacketValue;
   friend class RxJetiExPacketLabel;
-  friend class RxJetiDecode;
+  friend class RxJetiExIndex;
+  friend class RxJetiDecodeBase;
 public:
-  RxJetiExPacketName() : m_serialId( 0 ), m_pstrName( 0 ), m_pNext( 0 ), m_pFirstLabel( 0 ) { m_packetType = PACKET_NAME; }
+  RxJetiExPacketName() : m_bFlash( false ), m_serialId( 0 ), m_pstrName( 0 ), m_pNext( 0 ), m_pFirstLabel( 0 ), m_pLastLabel( 0 ) { m_packetType = PACKET_NAME; }
 
   uint32_t GetSerialId(){ return m_serialId; };
-  const char * GetName(){ if( m_pstrName ) return m_pstrName; return m_strUnknown; }
+  const char * GetName(){ if( m_pstrName ) return FlashString( m_pstrName, m_bFlash, SCRATCH_NAME ); return m_strUnknown; }
+  bool IsFlash(){ return m_bFlash; } // from flash dictionary
 
 protected:
+  bool     m_bFlash;   // name string is in flash
   uint32_t m_serialId;
   char *   m_pstrName;
   
   RxJetiExPacketName  * m_pNext;
   RxJetiExPacketLabel * m_pFirstLabel;
+  RxJetiExPacketLabel * m_pLastLabel;
+};
+
+#ifdef RXJETIEX_LATEST
+// last received value of a label
+struct RxJetiExLatest
+{
+  int32_t  value;     // raw value
+  uint8_t  exType;    // enDataType
+  uint8_t  exponent;  // 0, 1=10E-1, 2=10E-2
+  uint16_t nUpdates;  // number of received values, 0 = no value yet
+  uint32_t tiUpdate;  // clock of last update, millis() unless SetClock()
 };
+#endif
 
 class RxJetiExPacketLabel : public RxJetiExPacket
 {
   friend class RxJetiExPacketValue;
-  friend class RxJetiDecode;
+  friend class RxJetiExIndex;
+  friend class RxJetiDecodeBase;
 public:
-  RxJetiExPacketLabel() : m_id( 0 ), m_serialId( 0 ), m_pstrLabel( 0 ), m_pstrUnit( 0 ), m_pNext( 0 ), m_pName( 0 ) { m_packetType = PACKET_LABEL; }
+  RxJetiExPacketLabel() : m_id( 0 ), m_subIdx( 0 ), m_bFlash( false ), m_serialId( 0 ), m_pstrLabel( 0 ), m_pstrUnit( 0 ), m_pNext( 0 ), m_pName( 0 )
+  {
+    m_packetType = PACKET_LABEL;
+    #ifdef RXJETIEX_LATEST
+    memset( &m_latest, 0, sizeof( m_latest ) );
+    #endif
+  }
 
   uint8_t  GetId(){ return m_id; }   
   uint32_t GetSerialId(){ return m_serialId; };
 
   const char * GetName()  { if( m_pName )     return m_pName->GetName();    return m_strUnknown; }
-  const char * GetLabel() { if( m_pstrLabel ) return m_pstrLabel;           return m_strUnknown; }
-  const char * GetUnit()  { if( m_pstrUnit )  return m_pstrUnit;            return m_strUnknown; }
+  const char * GetLabel() { if( m_pstrLabel ) return FlashString( m_pstrLabel, m_bFlash, SCRATCH_LABEL ); return m_strUnknown; }
+  const char * GetUnit()  { if( m_pstrUnit )  return FlashString( m_pstrUnit,  m_bFlash, SCRATCH_UNIT );  return m_strUnknown; }
+  bool IsFlash(){ return m_bFlash; } // from flash dictionary
+
+  #ifdef RXJETIEX_LATEST
+  const RxJetiExLatest * GetLatest(){ return &m_latest; }
+  #endif
 
 protected:
   uint8_t  m_id;
+  uint8_t  m_subIdx;   // subscription index + 1, 0 = not subscribed
+  bool     m_bFlash;   // label and unit strings are in flash
   uint32_t m_serialId;
   char *   m_pstrLabel;
   char *   m_pstrUnit;
 
   RxJetiExPacketLabel * m_pNext;
   RxJetiExPacketName  * m_pName;
+
+  #ifdef RXJETIEX_LATEST
+  RxJetiExLatest m_latest;
+  #endif
+};
+
+// open addressing hash index of names and labels, key is (serialId, id), names have id 0
+// the slot array is provided by the owner, its size must be a power of two
+class RxJetiExIndex
+{
+public:
+  RxJetiExIndex() : m_pSlots( 0 ), m_mask( 0 ), m_nUsed( 0 ), m_bComplete( true ) {}
+
+  void Init( RxJetiExPacket ** pSlots, uint16_t nSlots ){ m_pSlots = pSlots; m_mask = nSlots - 1; Clear(); }
+  void Clear();
+
+  RxJetiExPacket * Find( uint32_t serialId, uint8_t id );
+  bool             Insert( uint32_t serialId, uint8_t id, RxJetiExPacket * pPacket ); // false if index is full
+  bool             IsComplete(){ return m_bComplete; } // false: some entries did not fit, a miss must be verified by list walk
+
+  // smallest power of two slot count, which takes nEntries within max. load
+  static constexpr uint16_t SlotsFor( uint16_t nEntries, uint16_t nSlots = 4 ){ return ( nSlots >> 2 ) * 3 >= nEntries ? nSlots : SlotsFor( nEntries, nSlots * 2 ); }
+
+  // also used by RxJetiExMerge
+  static inline uint16_t Hash( uint32_t serialId, uint8_t id )
+  {
+    uint16_t h = (uint16_t)serialId ^ (uint16_t)( serialId >> 16 );
+    h ^= h >> 7;
+    return h + id * 0x9D;
+  }
+
+protected:
+  static bool Match( RxJetiExPacket * pPacket, uint32_t serialId, uint8_t id );
+
+  RxJetiExPacket ** m_pSlots;
+  uint16_t          m_mask;
+  uint16_t          m_nUsed;
+  bool              m_bComplete;
+};
+
+// date and time of TYPE_DT values
+struct RxJetiExDate
+{
+  uint8_t  day;
+  uint8_t  month;
+  uint16_t year;
+};
+
+struct RxJetiExTime
+{
+  uint8_t  hour;
+  uint8_t  minute;
+  uint8_t  second;
 };
 
 class RxJetiExPacketValue : public RxJetiExPacket
 {
-  friend class RxJetiDecode;
+  friend class RxJetiDecodeBase;
+  friend class RxJetiExPacketBatch;
 public:
   RxJetiExPacketValue() : m_id( 0 ), m_pLabel( 0 ) { m_packetType = PACKET_VALUE; }
 
@@ -145,6 +334,7 @@ public:
   uint32_t GetSerialId(){ return m_serialId; };
   uint8_t  GetExType(){ return m_exType; };
   uint32_t GetRawValue(){ return m_value; };
+  uint8_t  GetExponent(){ return m_exponent; }; // 0, 1=10E-1, 2=10E-2
 
   const char * GetName()  { if( m_pLabel ) return m_pLabel->GetName();  return m_strUnknown; }
   const char * GetLabel() { if( m_pLabel ) return m_pLabel->GetLabel(); return m_strUnknown; }
@@ -156,10 +346,20 @@ public:
   bool  GetDate( uint8_t * pDay,  uint8_t * pMonth,  uint16_t * pYear );
   bool  GetTime( uint8_t * pHour, uint8_t * pMinute, uint8_t * pSecond );
 
+  // integer accessors, no float math (i.e. for AVR)
+  bool  GetInt( int32_t * pValue, uint8_t * pExponent );  // value = *pValue * 10^-(*pExponent)
+  bool  GetScaled( int32_t * pValue, uint8_t exponent );  // value in 10^-exponent units, i.e. exponent 2 = 0.01, rounded
+  bool  GetLatitudeE7( int32_t * pLatitude );             // 1E-7 degrees
+  bool  GetLongitudeE7( int32_t * pLongitude );
+  bool  GetDate( RxJetiExDate * pDate );
+  bool  GetTime( RxJetiExTime * pTime );
+
   bool  IsValueComplete(); // check if label or unit name is missing to eventually call "RxJetiExDecode::CompleteValue(...)" with previoulsy store sensor data
 
 protected:
   bool GetGPS( bool * pbLongitude, float * pCoord );
+  bool GetGPSE7( bool * pbLongitude, int32_t * pCoord );
+  bool GetGPSRaw( bool * pbLongitude, bool * pbNegative, uint16_t * pDeg, uint16_t * pMin );
   bool IsNumeric();
 
   uint8_t     m_id;
@@ -169,13 +369,19 @@ protected:
   uint8_t     m_exponent; // 0, 1=10E-1, 2=10E-2
 
   RxJetiExPacketLabel * m_pLabel;
+
+  union
+  {
+    uint32_t vInt;
+    uint8_t  vBytes[4];
+  } i2b; // integer to bytes and vice versa (value only, keeps dictionary records small)
 };
 
 class RxJetiPacketAlarm: public RxJetiExPacket
 {
-  friend class RxJetiDecode;
+  friend class RxJetiDecodeBase;
 public:
-  RxJetiPacketAlarm() : m_bSound( 0 ), m_code( 0 ) {}
+  RxJetiPacketAlarm() : m_bSound( 0 ), m_code( 0 ) { m_packetType = PACKET_ALARM; }
   bool    GetSound(){ return m_bSound; }
   uint8_t GetCode(){ return m_code; }
 protected:
@@ -183,6 +389,38 @@ protected:
   uint8_t m_code;
 };
 
+// compact value of a batch
+struct RxJetiExValueRecord
+{
+  RxJetiExPacketLabel * pLabel;   // NULL if label is unknown
+  int32_t               value;    // raw value
+  uint8_t               id;
+  uint8_t               exType;   // enDataType
+  uint8_t               exponent; // 0, 1=10E-1, 2=10E-2
+};
+
+// all values of an EX data frame in a caller provided array, an EX data frame has max. 12 values
+class RxJetiExPacketBatch : public RxJetiExPacket
+{
+  friend class RxJetiDecodeBase;
+  friend class RxJetiExMerge;
+public:
+  RxJetiExPacketBatch() : m_serialId( 0 ), m_pRecords( 0 ), m_nRecords( 0 ), m_nMax( 0 ), m_bMore( false ) { m_packetType = PACKET_BATCH; }
+
+  uint32_t              GetSerialId(){ return m_serialId; }
+  uint8_t               GetCount(){ return m_nRecords; }
+  RxJetiExValueRecord * GetRecords(){ return m_pRecords; }
+  bool                  HasMore(){ return m_bMore; } // batch was full, remaining values of the frame follow in the next batch
+  bool                  GetValue( uint8_t idx, RxJetiExPacketValue * pValue ); // as value packet, i.e. for GetFloat()
+
+protected:
+  uint32_t              m_serialId;
+  RxJetiExValueRecord * m_pRecords;
+  uint8_t               m_nRecords;
+  uint8_t               m_nMax;
+  bool                  m_bMore;
+};
+
 class RxJetiPacketText: public RxJetiExPacket
 {
 public:
@@ -190,31 +428,112 @@ public:
   char m_textBuffer[ 32 + 1 ];
 };
 
-class RxJetiDecode
+// packet output of RxJetiDecodeBase::Feed(), packet is valid during callback only
+typedef void (*RxJetiExPacketCallback)( RxJetiExPacket * pPacket, void * pContext );
+
+// subscribed value of a single sensor channel
+typedef void (*RxJetiExValueHandler)( RxJetiExPacketValue * pValue, void * pContext );
+
+// time source in ms, i.e. a simulated clock for accelerated replay
+typedef uint32_t (*RxJetiExClock)( void );
+
+// state machine, sensor dictionary and push interface, independent of serial port and storage sizes
+class RxJetiDecodeBase
 {
 public:
-  RxJetiDecode() : m_state( WAIT_STARTOFPACKET ), m_tiTimeout(0), m_enMsgType( MSGTYPE_TEXT ), m_nPacketLen( 0 ), m_nBytes( 0 ), m_pSensorList( 0 ) {}
-
-  enum enComPort
+  RxJetiDecodeBase() : m_state( WAIT_STARTOFPACKET ), m_tiLast( 0 ), m_tiNow( 0 ), m_pClock( DefaultClock ), m_bLinkLost( false ),
+                       m_tiByteTimeout( RXJETIEX_BYTE_TIMEOUT ), m_tiFrameTimeout( RXJETIEX_FRAME_TIMEOUT ), m_enMsgType( MSGTYPE_TEXT ), m_nPacketLen( 0 ), m_nBytes( 0 ),
+                       m_rxIdx( 0 ), m_rxCnt( 0 ), m_nByteBudget( RXJETIEX_BYTE_BUDGET ),
+                       m_pCallback( 0 ), m_pContext( 0 ), m_bTypeHandlers( false ), m_pSensorList( 0 ), m_pLastName( 0 ),
+                       m_pFlashDict( 0 ), m_nFlashDict( 0 ), m_pKeystream( 0 )
   {
-    DEFAULTPORT = 0x00,
-    SERIAL1     = 0x01,
-    SERIAL2     = 0x02,
-    SERIAL3     = 0x03,
-  };
+    #ifndef RXJETIEX_NO_RESYNC
+    m_nHist     = 0;
+    m_replayIdx = 0;
+    m_replayEnd = 0;
+    m_bResync   = true;
+    #endif
+    memset( m_typeHandlers, 0, sizeof( m_typeHandlers ) );
+    #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+    memset( m_subs, 0, sizeof( m_subs ) );
+    m_nSubs = 0;
+    #endif
+    ResetStats();
+  }
 
-  void             Start( enComPort comPort = DEFAULTPORT );
-  RxJetiExPacket * GetPacket(); 
+  void             SetByteBudget( uint8_t nBytes ){ m_nByteBudget = nBytes ? nBytes : 1; } // max. characters processed per GetPacket() call
+  bool             IsPending(){ return m_rxIdx < m_rxCnt || m_state == WAIT_NEXTVALUE || HasReplay(); } // characters or values read from the port, but not processed yet
+
+  // timing of GetPacket(), the clock is read once per call
+  void SetClock( RxJetiExClock pClock ){ m_pClock = pClock ? pClock : DefaultClock; }  // NULL = millis()
+  uint32_t GetTime(){ return m_tiNow; }  // clock of the current or last GetPacket() or Feed() call
+  void SetTimeouts( uint16_t tiByte, uint16_t tiFrame ){ m_tiByteTimeout = tiByte; m_tiFrameTimeout = tiFrame; } // inside / between frames in ms
+  bool IsLinkLost(){ return m_bLinkLost; } // no character for the inter-frame timeout, cleared by the next character
+
+  // push interface, independent of serial port (DMA buffers, files, relays, ...)
+  void   SetPacketCallback( RxJetiExPacketCallback pCallback, void * pContext = NULL ){ m_pCallback = pCallback; m_pContext = pContext; }
+  size_t Feed( const uint16_t * pWords, size_t nWords );                     // 9 bit words, returns number of emitted packets
+  size_t Feed( const uint8_t * pData, const uint8_t * pBit9, size_t nBytes ); // 8 bit data + 9th bits packed LSB first (bit i = 9th bit of pData[i])
+  void   ResetState();                                                       // i.e. after a gap in the pushed data
+  #ifndef RXJETIEX_NO_RESYNC
+  void   SetResync( bool bResync ){ m_bResync = bResync; }                   // rescan damaged frames for next start marker (default)
+  #endif
+
+  // batch mode: an EX data frame is returned as one PACKET_BATCH with all values, NULL = one PACKET_VALUE per value
+  // frames with more than nMax values continue in further batches, see RxJetiExPacketBatch::HasMore()
+  void   SetBatch( RxJetiExValueRecord * pRecords, uint8_t nMax ){ m_batch.m_pRecords = pRecords; m_batch.m_nMax = pRecords ? nMax : 0; }
+
+  // subscriptions, handlers are called from GetPacket() and Feed() before the packet is returned
+  void SubscribeType( uint8_t packetType, RxJetiExPacketCallback pHandler, void * pContext = NULL ); // all packets of enPacketType, NULL handler unsubscribes
+  #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+  bool Subscribe( uint32_t serialId, uint8_t id, RxJetiExValueHandler pHandler, void * pContext = NULL ); // false if RXJETIEX_MAX_SUBSCRIPTIONS exceeded
+  void Unsubscribe( uint32_t serialId, uint8_t id );
+  #endif
+
+  // statistics
+  #ifdef RXJETIEX_STATS
+  const RxJetiDecodeStats & GetStats(){ return m_stats; }
+  void ResetStats();
+  #else
+  void ResetStats(){}
+  #endif
 
   // add eventually missing label, unit and name from persisted data. Check "!RxJetiExPacketValue::>IsValueComplete()" if this is necessary 
   bool CompleteValue( RxJetiExPacketValue * pValue, const char * pstrName, const char * pstrLabel, const char * pstrUnit );
 
+  // direct name and label lookup
+  RxJetiExPacketName  * GetName( uint32_t serialId ){ return FindName( serialId ); }
+  RxJetiExPacketLabel * GetLabel( uint32_t serialId, uint8_t id ){ return FindLabel( serialId, id ); }
+
+  // dictionary memory
+  size_t GetDictionaryBytes(){ return m_arena.GetUsed(); }   // bytes used by names, labels and units
+  size_t GetDictionarySize(){ return m_arena.GetSize(); }    // RXJETIEX_ARENA_SIZE
+  uint16_t GetDictionaryFailed(){ return m_arena.GetFailed(); } // names or labels dropped, because dictionary was full
+  void   ResetDictionary();                                  // forget all sensors
+
+  // dictionary persistence for warm start, versioned binary blob with crc
+  bool   SaveDictionary( RxJetiExWriter & writer );
+  bool   LoadDictionary( RxJetiExReader & reader );          // replaces current dictionary, false if blob is invalid or dictionary is full
+
+  // read-only dictionary in flash, generated by extras/host/RxJetiExDictGen. Index misses are resolved by
+  // binary search of the table, a RAM record is allocated on first use, strings stay in flash.
+  // Survives ResetDictionary() and LoadDictionary()
+  #ifdef RXJETIEX_FLASH_DICT
+  bool   SetFlashDictionary( const RxJetiExFlashEntry * pTable, uint16_t nEntries ); // false if table is not sorted by (serialId, id)
+  #endif
+
   // name and label enumeration (i.e. for persistence)
   RxJetiExPacketName  * GetFirstName() { return m_pSensorList; }
   RxJetiExPacketName  * GetNextName( RxJetiExPacketName * pName ){ if( pName ) return pName->m_pNext; return NULL; }
   RxJetiExPacketLabel * GetFirstLabel( RxJetiExPacketName * pName ){ if( pName ) return pName->m_pFirstLabel; return NULL; }
   RxJetiExPacketLabel * GetNextLabel( RxJetiExPacketLabel * pLabel ){ if( pLabel ) return pLabel->m_pNext; return NULL; };
 
+  #ifdef RXJETIEX_LATEST
+  // last value of each label, i.e. for display or failsafe logic. Iterate with GetFirstName()... and RxJetiExPacketLabel::GetLatest()
+  const RxJetiExLatest * GetLatest( uint32_t serialId, uint8_t id ); // NULL if label is unknown
+  bool GetLatest( uint32_t serialId, uint8_t id, RxJetiExPacketValue * pValue ); // as value packet, false if no value yet
+  #endif
+
 protected:
 
   enum enPacketState
@@ -235,30 +554,165 @@ protected:
     MSGTYPE_MSG    = 2,
   };
 
-  // serial interface
-  RxJetiExSerial * m_pSerial;
+  // storage is owned by derived class
+  void InitStorage( RxJetiExPacket ** pIndexSlots, uint16_t nIndexSlots, uint8_t * pArena, size_t arenaSize )
+  {
+    m_index.Init( pIndexSlots, nIndexSlots );
+    m_arena.Init( pArena, arenaSize );
+  }
+
+  // pull packets from a port with Read( pWords, nWords ), shared by RxJetiDecode and RxJetiDecodeT
+  template< class PORT >
+  RxJetiExPacket * Poll( PORT & port, uint16_t * pWords, uint8_t nWords )
+  {
+    m_tiNow = m_pClock();
+
+    // process existing ex buffer witch values
+    if( m_state == WAIT_NEXTVALUE )
+      return Dispatch( NextValue() );
+
+    // process a burst of characters, at most m_nByteBudget per call
+    for( uint8_t n = 0; n < m_nByteBudget; n++ )
+    {
+      uint16_t c;
+      if( !NextReplay( &c ) ) // characters of a damaged frame first
+      {
+        if( m_rxIdx >= m_rxCnt )
+        {
+          m_rxCnt = port.Read( pWords, nWords );
+          m_rxIdx = 0;
+          if( m_rxCnt == 0 )
+          {
+            CheckTimeout();
+            break;
+          }
+        }
+        c = pWords[ m_rxIdx++ ];
+        m_tiLast    = m_tiNow;
+        m_bLinkLost = false;
+      }
+
+      RxJetiExPacket * pPacket = ProcessChar( c );
+      if( pPacket || m_state == WAIT_NEXTVALUE )
+        return Dispatch( pPacket );
+    }
+
+    return NULL;
+  }
 
   // packet state
   uint8_t m_state;
 
+  // timing, elapsed time is unsigned difference to survive clock wraparound
+  static uint32_t DefaultClock(){ return millis(); }
+  void            CheckTimeout();
+  uint32_t        m_tiLast;          // time of last character
+  uint32_t        m_tiNow;           // clock of current GetPacket() or Feed() call
+  RxJetiExClock   m_pClock;
+  bool            m_bLinkLost;
+  uint16_t        m_tiByteTimeout;
+  uint16_t        m_tiFrameTimeout;
+
   // data buffer handling
-  uint32_t  m_tiTimeout;
   enMsgType m_enMsgType;
   uint8_t   m_nPacketLen;    // length of EX data packet
   uint8_t   m_nBytes;        // current byte counter
+  uint8_t   m_crc;           // running crc of current EX packet
   uint8_t   m_exBuffer[32];  // EX data buffer
 
+  // receive burst buffer state
+  uint8_t   m_rxIdx;
+  uint8_t   m_rxCnt;
+  uint8_t   m_nByteBudget;
+
+  // resync: raw characters since start marker of current frame, replayed from next start marker after an error
+  #ifndef RXJETIEX_NO_RESYNC
+  uint16_t  m_hist[ RXJETIEX_RESYNC_SIZE ];
+  uint8_t   m_nHist;
+  uint8_t   m_replayIdx;
+  uint8_t   m_replayEnd;
+  bool      m_bResync;
+  bool NextReplay( uint16_t * pc ){ if( m_replayIdx >= m_replayEnd ) return false; *pc = m_hist[ m_replayIdx++ ]; return true; }
+  bool HasReplay(){ return m_replayIdx < m_replayEnd; }
+  void Resync();
+  #else
+  bool NextReplay( uint16_t * /* pc */ ){ return false; }
+  bool HasReplay(){ return false; }
+  #endif
+
+  RxJetiExPacket * DecodeChar( uint16_t c );
+  RxJetiExPacket * Error( uint8_t reason );
+  #ifdef RXJETIEX_STATS_TIMING
+  RxJetiExPacket * ProcessChar( uint16_t c ); // timed DecodeChar()
+  RxJetiExPacket * NextValue();
+  void             TimeFrame( uint32_t tiStart );
+  bool             m_bTiming;
+  uint32_t         m_tiFrame;
+  #else
+  RxJetiExPacket * ProcessChar( uint16_t c ){ RXJETIEX_STATS_INC( nBytes ); return DecodeChar( c ); }
+  RxJetiExPacket * NextValue();
+  #endif
+
+  // push interface
+  RxJetiExPacketCallback m_pCallback;
+  void *                 m_pContext;
+  size_t                 EmitPackets( RxJetiExPacket * pPacket );
+
+  // subscriptions
+  struct Handler
+  {
+    RxJetiExPacketCallback pHandler;
+    void *                 pContext;
+  };
+  Handler m_typeHandlers[ RxJetiExPacket::PACKET_BATCH + 1 ];
+  bool    m_bTypeHandlers; // any type handler set
+  #if RXJETIEX_MAX_SUBSCRIPTIONS > 0
+  struct Subscription
+  {
+    uint32_t             serialId;
+    uint8_t              id;       // 0 = unused
+    RxJetiExValueHandler pHandler;
+    void *               pContext;
+  };
+  Subscription m_subs[ RXJETIEX_MAX_SUBSCRIPTIONS ];
+  uint8_t      m_nSubs;            // highest used entry + 1
+  uint8_t      FindSubscription( uint32_t serialId, uint8_t id ); // index + 1, 0 = none
+  #endif
+  RxJetiExPacket * Dispatch( RxJetiExPacket * pPacket ){ if( pPacket ) CallHandlers( pPacket ); return pPacket; }
+  void             CallHandlers( RxJetiExPacket * pPacket );
+
   // EX decoder
   RxJetiExPacket * DecodeName();
   RxJetiExPacket * DecodeLabel();
   RxJetiExPacket * DecodeValue();
+  void             BeginValues();
+  RxJetiExPacket * DecodeBatch();
 
   // data output
   RxJetiExPacketName * m_pSensorList;
+  RxJetiExPacketName * m_pLastName;
+  const RxJetiExFlashEntry * m_pFlashDict;
+  uint16_t                   m_nFlashDict;
+  #ifdef RXJETIEX_FLASH_DICT
+  bool                  FindFlashEntry( uint32_t serialId, uint8_t id, RxJetiExFlashEntry * pEntry );
+  RxJetiExPacketName  * FlashName( uint32_t serialId );
+  RxJetiExPacketLabel * FlashLabel( uint32_t serialId, uint8_t id );
+  #else
+  RxJetiExPacketName  * FlashName( uint32_t /* serialId */ ){ return NULL; }
+  RxJetiExPacketLabel * FlashLabel( uint32_t /* serialId */, uint8_t /* id */ ){ return NULL; }
+  #endif
+  RxJetiExIndex        m_index;
+  RxJetiExArena        m_arena;
   RxJetiExPacketValue  m_value;
   RxJetiPacketAlarm    m_alarm;
   RxJetiExPacketError  m_error;
   RxJetiPacketText     m_text;
+  RxJetiExPacketBatch  m_batch;
+  RxJetiExCrypt        m_crypt;
+  const uint8_t *      m_pKeystream; // xor mask of current frame, NULL = not encrypted
+  #ifdef RXJETIEX_STATS
+  RxJetiDecodeStats    m_stats;
+  #endif
 
   // sensor helpers
   char * NewName();
@@ -267,12 +721,9 @@ protected:
   RxJetiExPacketName  * FindName( uint32_t serialId );
   RxJetiExPacketLabel * FindLabel( uint32_t serialId, uint8_t id );
   void AppendName( RxJetiExPacketName * pName );
-  void AppendLabel( RxJetiExPacketLabel * pLabel );
-
-  // Jeti Helpers
-  bool    crcCheck();
-  uint8_t update_crc (uint8_t crc, uint8_t crc_seed);
-  void    decrypt(uint8_t key, uint8_t*exbuf, unsigned char n); // decrypt legacy encryption
+  void AppendLabel( RxJetiExPacketName * pName, RxJetiExPacketLabel * pLabel );
+  RxJetiExPacketName * AddName( uint32_t serialId );
+  char * ReadString( RxJetiExReader & reader, uint8_t * pCrc );
 
   // debugging
   #ifdef RXJETIEX_DECODE_DEBUG
@@ -287,4 +738,41 @@ protected:
   #endif
 };
 
+// decoder with run time selected serial port, storage sized by RXJETIEX_INDEX_SIZE and RXJETIEX_ARENA_SIZE
+class RxJetiDecode : public RxJetiDecodeBase
+{
+public:
+  RxJetiDecode() : m_pSerial( 0 ) { InitStorage( m_indexSlots, RXJETIEX_INDEX_SIZE, m_arenaBuf, RXJETIEX_ARENA_SIZE ); }
+
+  enum enComPort
+  {
+    DEFAULTPORT = 0x00,
+    SERIAL1     = 0x01,
+    SERIAL2     = 0x02,
+    SERIAL3     = 0x03,
+  };
+
+  void             Start( enComPort comPort = DEFAULTPORT );
+  void             Start( RxJetiExSerial * pSerial ); // user supplied port, i.e. RxJetiExPosixSerial on host
+  RxJetiExPacket * GetPacket(){ return Poll( *m_pSerial, m_rxWords, RXJETIEX_READ_CHUNK ); }
+  RxJetiExSerial * GetSerial(){ return m_pSerial; } // i.e. for GetOverflows() and GetHighWater() of receive buffer
+
+  #ifdef RXJETIEX_STATS
+  const RxJetiDecodeStats & GetStats()
+  {
+    if( m_pSerial ) { m_stats.nOverflows = m_pSerial->GetOverflows(); m_stats.highWater = m_pSerial->GetHighWater(); }
+    return m_stats;
+  }
+  #endif
+
+protected:
+  // serial interface
+  RxJetiExSerial * m_pSerial;
+  uint16_t         m_rxWords[ RXJETIEX_READ_CHUNK ];
+
+  // dictionary storage
+  RxJetiExPacket * m_indexSlots[ RXJETIEX_INDEX_SIZE ];
+  uint8_t          m_arenaBuf[ RXJETIEX_ARENA_SIZE ];
+};
+
 #endif // RXJETIEXDECODE_H
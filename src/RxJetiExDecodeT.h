@@ -0,0 +1,89 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiDecodeT - compile time configured decoder, no virtual calls, no heap
+  --------------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXDECODET_H
+#define RXJETIEXDECODET_H
+
+#include "RxJetiExDecode.h"
+
+// PORT:        serial backend, i.e. RxJetiExHardwareSerialInt, RxJetiExTeensySerial, RxJetiExPosixSerial
+//              or any class with Init() and Read( uint16_t * pDst, size_t nMax ), called non virtual
+// MAX_SENSORS: number of sensor names stored in dictionary
+// MAX_LABELS:  number of labels stored in dictionary, all sensors
+// READ_CHUNK:  number of characters taken from the port per Read()
+//
+// Usage:       RxJetiDecodeT< RxJetiExHardwareSerialInt, 4, 32 > jetiDecode;
+//              jetiDecode.Start();
+//              RxJetiExPacket * pPacket = jetiDecode.GetPacket();
+template< class PORT, uint8_t MAX_SENSORS = 8, uint8_t MAX_LABELS = 64, uint8_t READ_CHUNK = RXJETIEX_READ_CHUNK >
+class RxJetiDecodeT : public RxJetiDecodeBase
+{
+public:
+  // constructor arguments are passed to the port
+  template< typename... ARGS >
+  RxJetiDecodeT( ARGS... args ) : m_port( args... ) { InitStorage( m_indexSlots, INDEX_SIZE, m_arenaBuf, ARENA_SIZE ); }
+
+  void             Start(){ m_port.PORT::Init(); }
+  RxJetiExPacket * GetPacket(){ StaticPort port( m_port ); return Poll( port, m_rxWords, READ_CHUNK ); }
+  PORT &           GetSerial(){ return m_port; } // i.e. for GetOverflows() and GetHighWater() of receive buffer
+
+  #ifdef RXJETIEX_STATS
+  const RxJetiDecodeStats & GetStats()
+  {
+    m_stats.nOverflows = m_port.PORT::GetOverflows();
+    m_stats.highWater  = m_port.PORT::GetHighWater();
+    return m_stats;
+  }
+  #endif
+
+protected:
+  // qualified call, resolved at compile time and inlined into the poll loop
+  struct StaticPort
+  {
+    StaticPort( PORT & port ) : m_port( port ) {}
+    size_t Read( uint16_t * pDst, size_t nMax ){ return m_port.PORT::Read( pDst, nMax ); }
+    PORT & m_port;
+  };
+
+  enum
+  {
+    INDEX_SIZE = RxJetiExIndex::SlotsFor( MAX_SENSORS + MAX_LABELS ),
+    ARENA_SIZE = MAX_SENSORS * ( sizeof( RxJetiExPacketName )  + RxJetiExArena::ALIGN + 16 )  // name ~16 chars
+               + MAX_LABELS  * ( sizeof( RxJetiExPacketLabel ) + RxJetiExArena::ALIGN + 20 ), // label + unit
+  };
+
+  PORT             m_port;
+  uint16_t         m_rxWords[ READ_CHUNK ];
+  RxJetiExPacket * m_indexSlots[ INDEX_SIZE ];
+  uint8_t          m_arenaBuf[ ARENA_SIZE ];
+};
+
+#endif // RXJETIEXDECODET_H
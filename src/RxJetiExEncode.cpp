@@ -0,0 +1,246 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExEncode - builds EX frames as 9 bit words (test streams, simulators)
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExEncode.h"
+
+// 0x7E, ex type, length, body with serial id and key at offset 4, crc of encrypted data
+uint8_t RxJetiEncode::Frame( uint16_t * pDst, uint8_t msgType, uint8_t * pBody, uint8_t nBody )
+{
+  uint8_t nPacketLen = nBody + 1;
+  uint8_t lenByte    = ( msgType << 6 ) | nPacketLen;
+
+  pBody[ 4 ] = m_key;
+  if( m_key )
+    for( uint8_t i = 5; i < nBody; i++ )
+      pBody[ i ] ^= RxJetiExCrypt::Mask( m_key, i, nPacketLen );
+
+  uint8_t n   = 0;
+  uint8_t crc = RxJetiExCrc::Crc8Update( 0, lenByte );
+  pDst[ n++ ] = 0x007E;
+  pDst[ n++ ] = 0x019F;
+  pDst[ n++ ] = 0x0100 | lenByte;
+  for( uint8_t i = 0; i < nBody; i++ )
+  {
+    crc = RxJetiExCrc::Crc8Update( crc, pBody[ i ] );
+    pDst[ n++ ] = 0x0100 | pBody[ i ];
+  }
+  pDst[ n++ ] = 0x0100 | crc;
+  return n;
+}
+
+// text frame body: serial id, key, id, length byte (5 bit / 3 bit), strings
+uint8_t RxJetiEncode::Strings( uint8_t * pBody, uint32_t serialId, uint8_t id, const char * pStr1, const char * pStr2 )
+{
+  size_t len1 = pStr1 ? strlen( pStr1 ) : 0;
+  size_t len2 = pStr2 ? strlen( pStr2 ) : 0;
+  if( len1 > 0x1F || len2 > 0x07 || 7 + len1 + len2 > MAX_BODY )
+    return 0;
+
+  memcpy( pBody, &serialId, 4 );
+  pBody[ 5 ] = id;
+  pBody[ 6 ] = (uint8_t)( ( len1 << 3 ) | len2 );
+  memcpy( &pBody[ 7 ], pStr1, len1 );
+  memcpy( &pBody[ 7 + len1 ], pStr2, len2 );
+  return (uint8_t)( 7 + len1 + len2 );
+}
+
+uint8_t RxJetiEncode::EncodeName( uint16_t * pDst, uint32_t serialId, const char * pName )
+{
+  uint8_t body[ MAX_BODY ];
+  uint8_t nBody = Strings( body, serialId, 0, pName, NULL );
+  return nBody ? Frame( pDst, 0, body, nBody ) : 0;
+}
+
+uint8_t RxJetiEncode::EncodeLabel( uint16_t * pDst, uint32_t serialId, uint8_t id, const char * pLabel, const char * pUnit )
+{
+  uint8_t body[ MAX_BODY ];
+  uint8_t nBody = id ? Strings( body, serialId, id, pLabel, pUnit ) : 0; // id 0 is the sensor name
+  return nBody ? Frame( pDst, 0, body, nBody ) : 0;
+}
+
+uint8_t RxJetiEncode::EncodeAlarm( uint16_t * pDst, uint8_t code, bool bSound )
+{
+  pDst[ 0 ] = 0x007E;
+  pDst[ 1 ] = 0x0192;
+  pDst[ 2 ] = 0x0100 | ( bSound ? 0x23 : 0x22 );
+  pDst[ 3 ] = 0x0100 | code;
+  return 4;
+}
+
+uint8_t RxJetiEncode::EncodeText( uint16_t * pDst, const char * pText )
+{
+  uint8_t n = 0;
+  pDst[ n++ ] = 0x00FE;
+  for( ; *pText && n <= 32; pText++ )
+    pDst[ n++ ] = 0x0100 | (uint8_t)*pText;
+  pDst[ n++ ] = 0x00FF;
+  return n;
+}
+
+void RxJetiEncode::BeginData( uint32_t serialId )
+{
+  m_serialId = serialId;
+  memcpy( m_data, &serialId, 4 );
+  m_nData = 5;
+}
+
+bool RxJetiEncode::AddValue( uint8_t id, uint8_t exType, int32_t value, uint8_t exponent )
+{
+  uint8_t  nBytes;
+  uint8_t  nBits;
+  switch( exType )
+  {
+  case RxJetiExPacket::TYPE_6b:  nBytes = 1; nBits = 5;  break;
+  case RxJetiExPacket::TYPE_14b: nBytes = 2; nBits = 13; break;
+  case RxJetiExPacket::TYPE_22b: nBytes = 3; nBits = 21; break;
+  case RxJetiExPacket::TYPE_30b: nBytes = 4; nBits = 29; break;
+  case RxJetiExPacket::TYPE_DT:  nBytes = 3; nBits = 0;  break;
+  case RxJetiExPacket::TYPE_GPS: nBytes = 4; nBits = 0;  break;
+  default:
+    return false;
+  }
+  if( m_nData + ( id > 15 ? 2 : 1 ) + nBytes > MAX_BODY )
+    return false;
+
+  // type and id, ids > 15 in an extra byte
+  m_data[ m_nData++ ] = ( id > 15 ? 0 : id << 4 ) | exType;
+  if( id > 15 )
+    m_data[ m_nData++ ] = id;
+
+  uint32_t raw = (uint32_t)value;
+  if( nBits )
+  {
+    // sign, exponent and magnitude in the top byte
+    uint32_t mag = value < 0 ? -value : value;
+    if( mag >> nBits )
+      mag = ( 1UL << nBits ) - 1; // saturate
+    raw = mag | ( (uint32_t)( exponent & 0x03 ) << ( nBits ) ) | ( value < 0 ? 1UL << ( nBits + 2 ) : 0 );
+  }
+  for( uint8_t i = 0; i < nBytes; i++, raw >>= 8 )
+    m_data[ m_nData++ ] = (uint8_t)raw;
+  return true;
+}
+
+bool RxJetiEncode::AddGPS( uint8_t id, int32_t coordE7, bool bLongitude )
+{
+  uint32_t mag  = coordE7 < 0 ? -coordE7 : coordE7;
+  uint16_t deg  = mag / 10000000UL;
+  uint32_t min  = ( ( mag % 10000000UL ) * 3 + 250 ) / 500; // 1/1000 minutes
+  if( min > 0xFFFF )
+    min = 0xFFFF;
+  uint32_t raw = min | ( (uint32_t)( deg & 0xFF ) << 16 ) | ( (uint32_t)( deg >> 8 ) << 24 );
+  if( bLongitude )
+    raw |= 0x20000000UL;
+  if( coordE7 < 0 )
+    raw |= 0x40000000UL;
+  return AddValue( id, RxJetiExPacket::TYPE_GPS, (int32_t)raw );
+}
+
+bool RxJetiEncode::AddDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year )
+{
+  return AddValue( id, RxJetiExPacket::TYPE_DT, ( (int32_t)( 0x20 | ( day & 0x1F ) ) << 16 ) | ( (int32_t)month << 8 ) | (uint8_t)( year - 2000 ) );
+}
+
+bool RxJetiEncode::AddTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second )
+{
+  return AddValue( id, RxJetiExPacket::TYPE_DT, ( (int32_t)( hour & 0x1F ) << 16 ) | ( (int32_t)minute << 8 ) | second );
+}
+
+uint8_t RxJetiEncode::EndData( uint16_t * pDst )
+{
+  if( m_nData <= 5 )
+    return 0;
+  uint8_t n = Frame( pDst, 1, m_data, m_nData );
+  BeginData( m_serialId );
+  return n;
+}
+
+// EX Bus
+/////////
+
+// header, 0x01, length, packet id, data id, data length, data, crc16 little endian
+uint8_t RxJetiExBusEncode::Frame( uint8_t * pDst, uint8_t header, uint8_t packetId, uint8_t dataId, uint8_t nData )
+{
+  uint8_t n = nData + 8;
+  pDst[ 0 ] = header;
+  pDst[ 1 ] = 0x01;
+  pDst[ 2 ] = n;
+  pDst[ 3 ] = packetId;
+  pDst[ 4 ] = dataId;
+  pDst[ 5 ] = nData;
+
+  uint16_t crc = 0;
+  for( uint8_t i = 0; i < n - 2; i++ )
+    crc = RxJetiExCrc::Crc16Update( crc, pDst[ i ] );
+  pDst[ n - 2 ] = (uint8_t)crc;
+  pDst[ n - 1 ] = (uint8_t)( crc >> 8 );
+  return n;
+}
+
+uint8_t RxJetiExBusEncode::EncodeChannels( uint8_t * pDst, uint8_t packetId, const uint16_t * pChannels, uint8_t nChannels, bool bRequest )
+{
+  if( nChannels > 24 )
+    return 0;
+  for( uint8_t i = 0; i < nChannels; i++ )
+  {
+    pDst[ 6 + 2 * i ] = (uint8_t)pChannels[ i ];
+    pDst[ 7 + 2 * i ] = (uint8_t)( pChannels[ i ] >> 8 );
+  }
+  return Frame( pDst, bRequest ? RXJETIEX_BUS_REQUEST : RXJETIEX_BUS_HEADER, packetId, RXJETIEX_BUS_CHANNEL, 2 * nChannels );
+}
+
+uint8_t RxJetiExBusEncode::EncodeTelemetryRequest( uint8_t * pDst, uint8_t packetId )
+{
+  return Frame( pDst, RXJETIEX_BUS_REQUEST, packetId, RXJETIEX_BUS_TELEMETRY, 0 );
+}
+
+uint8_t RxJetiExBusEncode::EncodeJetiBoxRequest( uint8_t * pDst, uint8_t packetId, uint8_t buttons )
+{
+  pDst[ 6 ] = (uint8_t)( ~buttons & 0xF0 ) | 0x0F; // low active
+  return Frame( pDst, RXJETIEX_BUS_REQUEST, packetId, RXJETIEX_BUS_JETIBOX, 1 );
+}
+
+uint8_t RxJetiExBusEncode::EncodeTelemetry( uint8_t * pDst, uint8_t packetId, const uint16_t * pWords, uint8_t nWords )
+{
+  if( nWords < 2 || pWords[ 0 ] != 0x007E || nWords - 1 > RXJETIEX_BUS_FRAME_MAX - 8 )
+    return 0;
+  for( uint8_t i = 1; i < nWords; i++ )
+    pDst[ 5 + i ] = (uint8_t)pWords[ i ];
+  return Frame( pDst, RXJETIEX_BUS_ANSWER, packetId, RXJETIEX_BUS_TELEMETRY, nWords - 1 );
+}
+
+uint8_t RxJetiExBusEncode::EncodeJetiBox( uint8_t * pDst, uint8_t packetId, const char * pText )
+{
+  uint8_t n = 0;
+  for( ; *pText && n < 32; pText++ )
+    pDst[ 6 + n++ ] = (uint8_t)*pText;
+  return Frame( pDst, RXJETIEX_BUS_ANSWER, packetId, RXJETIEX_BUS_JETIBOX, n );
+}
@@ -0,0 +1,107 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExEncode - builds EX frames as 9 bit words and EX Bus frames (test streams, simulators)
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXENCODE_H
+#define RXJETIEXENCODE_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+#include "RxJetiExDecode.h"
+#include "RxJetiExBus.h"
+
+#define RXJETIEX_ENCODE_MAX 34 // max. words of a frame: 0x7E, type, length, 31 bytes / 0xFE, 32 characters, 0xFF
+
+// Usage:
+//   RxJetiEncode encode;
+//   uint16_t     words[ RXJETIEX_ENCODE_MAX ];
+//   uint8_t      n = encode.EncodeName( words, 0xA4095501, "MySensor" );
+//
+//   encode.BeginData( 0xA4095501 );
+//   encode.AddValue( 1, RxJetiExPacket::TYPE_14b, 1234, 2 ); // 12.34
+//   n = encode.EndData( words );
+class RxJetiEncode
+{
+public:
+  RxJetiEncode() : m_key( 0 ), m_serialId( 0 ), m_nData( 0 ) {}
+
+  void SetKey( uint8_t key ){ m_key = key; } // legacy encryption, 0 = off
+
+  // complete frames, pDst holds RXJETIEX_ENCODE_MAX words, returns number of words, 0 if the strings don't fit
+  uint8_t EncodeName( uint16_t * pDst, uint32_t serialId, const char * pName );
+  uint8_t EncodeLabel( uint16_t * pDst, uint32_t serialId, uint8_t id, const char * pLabel, const char * pUnit ); // unit max. 7 characters
+  uint8_t EncodeAlarm( uint16_t * pDst, uint8_t code, bool bSound = true );
+  uint8_t EncodeText( uint16_t * pDst, const char * pText ); // JetiBox text, max. 32 characters
+
+  // data frame, the Add functions return false if the value doesn't fit into the frame
+  void    BeginData( uint32_t serialId );
+  bool    AddValue( uint8_t id, uint8_t exType, int32_t value, uint8_t exponent = 0 ); // TYPE_DT and TYPE_GPS take the raw value
+  bool    AddGPS( uint8_t id, int32_t coordE7, bool bLongitude );                    // 1E-7 degrees
+  bool    AddDate( uint8_t id, uint8_t day, uint8_t month, uint16_t year );
+  bool    AddTime( uint8_t id, uint8_t hour, uint8_t minute, uint8_t second );
+  uint8_t EndData( uint16_t * pDst );
+
+protected:
+  enum { MAX_BODY = 30 }; // 5 bit length incl. crc
+  uint8_t Frame( uint16_t * pDst, uint8_t msgType, uint8_t * pBody, uint8_t nBody );
+  uint8_t Strings( uint8_t * pBody, uint32_t serialId, uint8_t id, const char * pStr1, const char * pStr2 );
+
+  uint8_t  m_key;
+  uint32_t m_serialId;
+  uint8_t  m_data[ MAX_BODY ];
+  uint8_t  m_nData;
+};
+
+// EX Bus frames as bytes with crc16, pDst holds RXJETIEX_BUS_FRAME_MAX bytes, functions return number of bytes, 0 if the data doesn't fit
+//
+// Usage:
+//   uint8_t frame[ RXJETIEX_BUS_FRAME_MAX ];
+//   uint8_t n = RxJetiExBusEncode::EncodeChannels( frame, packetId, channels, 16 );
+//
+//   nWords = encode.EndData( words );                                             // EX frame of RxJetiEncode
+//   n      = RxJetiExBusEncode::EncodeTelemetry( frame, packetId, words, nWords ); // device answer to a telemetry request
+class RxJetiExBusEncode
+{
+public:
+  static uint8_t EncodeChannels( uint8_t * pDst, uint8_t packetId, const uint16_t * pChannels, uint8_t nChannels, bool bRequest = false ); // 1/8 us, max. 24
+  static uint8_t EncodeTelemetryRequest( uint8_t * pDst, uint8_t packetId );
+  static uint8_t EncodeJetiBoxRequest( uint8_t * pDst, uint8_t packetId, uint8_t buttons );   // RxJetiExPacketJetiBox::enButton bits of pressed buttons
+  static uint8_t EncodeTelemetry( uint8_t * pDst, uint8_t packetId, const uint16_t * pWords, uint8_t nWords ); // EX frame, 0x7E separator is dropped
+  static uint8_t EncodeJetiBox( uint8_t * pDst, uint8_t packetId, const char * pText );       // max. 32 characters
+
+protected:
+  static uint8_t Frame( uint8_t * pDst, uint8_t header, uint8_t packetId, uint8_t dataId, uint8_t nData ); // data is at pDst + 6
+};
+
+#endif // RXJETIEXENCODE_H
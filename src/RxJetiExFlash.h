@@ -0,0 +1,72 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExFlash - flash (PROGMEM) access and read-only sensor dictionary table
+  ----------------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXFLASH_H
+#define RXJETIEXFLASH_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+// #define RXJETIEX_FLASH_DICT // SetFlashDictionary() on AVR, costs 96 bytes RAM for string copies. Always available elsewhere
+
+#if defined (__AVR__)
+  #include <avr/pgmspace.h>
+  #define RXJETIEX_PROGMEM                   PROGMEM
+  #define RXJETIEX_READ_BYTE( addr )         pgm_read_byte( addr )
+  #define RXJETIEX_READ_WORD( addr )         pgm_read_word( addr )
+  #define RXJETIEX_MEMCPY_P( dst, src, n )   memcpy_P( dst, src, n )
+  #ifdef RXJETIEX_FLASH_DICT
+    #define RXJETIEX_FLASH_STRINGS           // strings in flash need a copy to RAM
+  #endif
+#else
+  #ifndef RXJETIEX_FLASH_DICT
+    #define RXJETIEX_FLASH_DICT              // flash is addressable, no copies
+  #endif
+  #define RXJETIEX_PROGMEM
+  #define RXJETIEX_READ_BYTE( addr )         (*(addr))
+  #define RXJETIEX_READ_WORD( addr )         (*(addr))
+  #define RXJETIEX_MEMCPY_P( dst, src, n )   memcpy( dst, src, n )
+#endif
+
+// entry of a read-only sensor dictionary, generated by extras/host/RxJetiExDictGen
+// table and strings are in flash, entries sorted by serialId and id for binary search
+struct RxJetiExFlashEntry
+{
+  uint32_t     serialId;
+  uint8_t      id;       // 0 = sensor name
+  const char * pstrText; // sensor name or label
+  const char * pstrUnit; // NULL for sensor name
+};
+
+#endif // RXJETIEXFLASH_H
@@ -0,0 +1,177 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExMerge - merged view of several decoders (i.e. dual receivers)
+  ---------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExMerge.h"
+
+RxJetiExMerge::RxJetiExMerge() : m_nDecoders( 0 ), m_next( 0 ), m_source( 0 ), m_nUsed( 0 ), m_nDuplicates( 0 )
+{
+  memset( m_values, 0, sizeof( m_values ) );
+  for( uint16_t i = 0; i < RXJETIEX_MERGE_SIZE; i++ )
+    m_values[ i ].source = m_values[ i ].labelSource = 0xFF;
+}
+
+bool RxJetiExMerge::AddDecoder( RxJetiDecode * pDecoder )
+{
+  if( m_nDecoders >= RXJETIEX_MERGE_MAX_DECODERS )
+    return false;
+  m_pDecoders[ m_nDecoders++ ] = pDecoder;
+  return true;
+}
+
+RxJetiExPacket * RxJetiExMerge::GetPacket()
+{
+  for( uint8_t n = 0; n < m_nDecoders; n++ )
+  {
+    uint8_t source = m_next;
+    m_next = ( m_next + 1 ) % m_nDecoders;
+
+    RxJetiDecode *   pDecoder = m_pDecoders[ source ];
+    RxJetiExPacket * pPacket;
+    while( ( pPacket = pDecoder->GetPacket() ) != NULL )
+    {
+      if( Filter( pPacket, source, pDecoder->GetTime() ) )
+      {
+        m_source = source;
+        return pPacket;
+      }
+    }
+  }
+  return NULL;
+}
+
+bool RxJetiExMerge::Filter( RxJetiExPacketValue * pValue, uint8_t source, uint32_t tiNow )
+{
+  return FilterValue( pValue->GetSerialId(), pValue->GetId(), pValue->GetExType(), pValue->GetExponent(), pValue->GetRawValue(), source, tiNow );
+}
+
+bool RxJetiExMerge::Filter( RxJetiExPacketBatch * pBatch, uint8_t source, uint32_t tiNow )
+{
+  RxJetiExValueRecord * pRecords = pBatch->m_pRecords;
+  uint8_t               n        = 0;
+  for( uint8_t i = 0; i < pBatch->m_nRecords; i++ )
+  {
+    RxJetiExValueRecord * pRecord = &pRecords[ i ];
+    if( FilterValue( pBatch->m_serialId, pRecord->id, pRecord->exType, pRecord->exponent, pRecord->value, source, tiNow ) )
+    {
+      if( n != i )
+        pRecords[ n ] = *pRecord;
+      n++;
+    }
+  }
+  pBatch->m_nRecords = n;
+  return n > 0;
+}
+
+bool RxJetiExMerge::FilterValue( uint32_t serialId, uint8_t id, uint8_t exType, uint8_t exponent, int32_t value, uint8_t source, uint32_t tiNow )
+{
+  RxJetiExMergeValue * pEntry = Find( serialId, id, true );
+  if( pEntry == NULL )
+    return true; // table full, pass everything
+
+  // same value already delivered by another decoder
+  if( pEntry->source != source && pEntry->source != 0xFF && pEntry->value == value && pEntry->exType == exType &&
+      tiNow - pEntry->tiUpdate < RXJETIEX_MERGE_WINDOW )
+  {
+    m_nDuplicates++;
+    return false;
+  }
+
+  pEntry->source   = source;
+  pEntry->exType   = exType;
+  pEntry->exponent = exponent;
+  pEntry->value    = value;
+  pEntry->tiUpdate = tiNow;
+  return true;
+}
+
+bool RxJetiExMerge::Filter( RxJetiExPacket * pPacket, uint8_t source, uint32_t tiNow )
+{
+  switch( pPacket->GetPacketType() )
+  {
+  case RxJetiExPacket::PACKET_VALUE:
+    return Filter( (RxJetiExPacketValue *)pPacket, source, tiNow );
+  case RxJetiExPacket::PACKET_BATCH:
+    return Filter( (RxJetiExPacketBatch *)pPacket, source, tiNow );
+  case RxJetiExPacket::PACKET_NAME:
+    return FilterLabel( ((RxJetiExPacketName *)pPacket)->GetSerialId(), 0, source );
+  case RxJetiExPacket::PACKET_LABEL:
+    return FilterLabel( ((RxJetiExPacketLabel *)pPacket)->GetSerialId(), ((RxJetiExPacketLabel *)pPacket)->GetId(), source );
+  default:
+    return true;
+  }
+}
+
+// name or label already known from another decoder
+bool RxJetiExMerge::FilterLabel( uint32_t serialId, uint8_t id, uint8_t source )
+{
+  RxJetiExMergeValue * pEntry = Find( serialId, id, true );
+  if( pEntry == NULL )
+    return true; // table full, pass everything
+
+  if( pEntry->labelSource == 0xFF )
+    pEntry->labelSource = source;
+  if( pEntry->labelSource != source )
+  {
+    m_nDuplicates++;
+    return false;
+  }
+  return true;
+}
+
+const RxJetiExMergeValue * RxJetiExMerge::GetValue( uint32_t serialId, uint8_t id )
+{
+  RxJetiExMergeValue * pEntry = Find( serialId, id, false );
+  if( pEntry == NULL || pEntry->source == 0xFF )
+    return NULL; // label only
+  return pEntry;
+}
+
+// open addressing, same hash as dictionary index
+RxJetiExMergeValue * RxJetiExMerge::Find( uint32_t serialId, uint8_t id, bool bInsert )
+{
+  const uint16_t mask = RXJETIEX_MERGE_SIZE - 1;
+  for( uint16_t i = RxJetiExIndex::Hash( serialId, id ) & mask, n = 0; n < RXJETIEX_MERGE_SIZE; i = ( i + 1 ) & mask, n++ )
+  {
+    RxJetiExMergeValue * pEntry = &m_values[ i ];
+    if( pEntry->source == 0xFF && pEntry->labelSource == 0xFF ) // unused, entries are filled right after insertion
+    {
+      if( !bInsert || m_nUsed >= ( RXJETIEX_MERGE_SIZE >> 2 ) * 3 ) // keep load factor <= 3/4
+        return NULL;
+      pEntry->serialId = serialId;
+      pEntry->id       = id;
+      m_nUsed++;
+      return pEntry;
+    }
+    if( pEntry->id == id && pEntry->serialId == serialId )
+      return pEntry;
+  }
+  return NULL;
+}
@@ -0,0 +1,97 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExMerge - merged view of several decoders (i.e. dual receivers)
+  ---------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXMERGE_H
+#define RXJETIEXMERGE_H
+
+#include "RxJetiExDecode.h"
+
+#ifndef RXJETIEX_MERGE_SIZE
+  #if defined (__AVR__)
+    #define RXJETIEX_MERGE_SIZE  16 // sensor values and labels tracked (power of two), max. 3/4 are used
+  #else
+    #define RXJETIEX_MERGE_SIZE 128
+  #endif
+#endif
+#ifndef RXJETIEX_MERGE_WINDOW
+  #define RXJETIEX_MERGE_WINDOW 250 // [ms] same value from another decoder within this time is a duplicate
+#endif
+#define RXJETIEX_MERGE_MAX_DECODERS 4
+
+// freshest value of a sensor channel
+struct RxJetiExMergeValue
+{
+  uint32_t serialId;
+  uint8_t  id;          // 0 = sensor name
+  uint8_t  source;      // decoder index of value, 0xFF = no value yet
+  uint8_t  labelSource; // decoder index that delivers name or label, 0xFF = none yet (both 0xFF = unused)
+  uint8_t  exType;      // enDataType
+  uint8_t  exponent;
+  int32_t  value;     // raw value
+  uint32_t tiUpdate;  // clock of the delivering decoder, see RxJetiDecodeBase::GetTime()
+};
+
+class RxJetiExMerge
+{
+public:
+  RxJetiExMerge();
+
+  // pull interface: polls all decoders round robin, duplicate values are dropped (batches are compacted),
+  // names and labels are passed from the first decoder that delivers them only,
+  // alarms, text and errors are passed from every decoder
+  bool             AddDecoder( RxJetiDecode * pDecoder ); // false if more than RXJETIEX_MERGE_MAX_DECODERS
+  RxJetiExPacket * GetPacket();
+  uint8_t          GetSource(){ return m_source; }        // decoder index of last packet
+
+  // push interface (Feed(), RxJetiDecodeT): true if value is new or changed, false if duplicate
+  // tiNow is GetTime() of the decoder, so the merge window runs on the decoders' clock
+  bool             Filter( RxJetiExPacketValue * pValue, uint8_t source, uint32_t tiNow );
+  bool             Filter( RxJetiExPacketBatch * pBatch, uint8_t source, uint32_t tiNow ); // removes duplicate records, false if none is left
+  bool             Filter( RxJetiExPacket * pPacket, uint8_t source, uint32_t tiNow ); // any packet type, as GetPacket()
+
+  const RxJetiExMergeValue * GetValue( uint32_t serialId, uint8_t id ); // NULL if not received yet
+  uint16_t                   GetDuplicates(){ return m_nDuplicates; }
+
+protected:
+  RxJetiExMergeValue * Find( uint32_t serialId, uint8_t id, bool bInsert );
+  bool                 FilterLabel( uint32_t serialId, uint8_t id, uint8_t source );
+  bool                 FilterValue( uint32_t serialId, uint8_t id, uint8_t exType, uint8_t exponent, int32_t value, uint8_t source, uint32_t tiNow );
+
+  RxJetiDecode *     m_pDecoders[ RXJETIEX_MERGE_MAX_DECODERS ];
+  uint8_t            m_nDecoders;
+  uint8_t            m_next;
+  uint8_t            m_source;
+  uint16_t           m_nUsed;
+  uint16_t           m_nDuplicates;
+  RxJetiExMergeValue m_values[ RXJETIEX_MERGE_SIZE ];
+};
+
+#endif // RXJETIEXMERGE_H
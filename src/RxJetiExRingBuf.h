@@ -0,0 +1,122 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExRingBuf - lock free single producer/single consumer ring buffer
+                    producer: receiver ISR, consumer: main loop
+  -------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXRINGBUF_H
+#define RXJETIEXRINGBUF_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+// SIZE must be a power of two (2..256), one slot is kept free to tell full from empty.
+// Head is written by the producer only, tail by the consumer only. Both are single bytes,
+// so reading them is atomic on 8 bit MCUs and no interrupt lock is needed.
+template< class T, uint16_t SIZE >
+class RxJetiExRingBuf
+{
+  static_assert( SIZE >= 2 && SIZE <= 256 && ( SIZE & ( SIZE - 1 ) ) == 0, "ring buffer size must be a power of two <= 256" );
+
+public:
+  RxJetiExRingBuf() { Reset(); }
+
+  void Reset(){ m_head = 0; m_tail = 0; m_overflows = 0; m_highWater = 0; } // call with receiver disabled
+
+  // producer (ISR), returns false and counts the overflow if buffer is full
+  inline bool Put( T c )
+  {
+    uint8_t head = m_head;
+    uint8_t next = ( head + 1 ) & MASK;
+    uint8_t tail = m_tail;
+    if( next == tail )
+    {
+      if( m_overflows != 0xFFFF )
+        m_overflows++;
+      return false;
+    }
+    m_buf[ head ] = c;
+    m_head = next;
+
+    uint8_t n = ( next - tail ) & MASK;
+    if( n > m_highWater )
+      m_highWater = n;
+    return true;
+  }
+
+  // consumer (main loop), returns false if buffer is empty
+  inline bool Get( T * pc )
+  {
+    uint8_t tail = m_tail;
+    if( tail == m_head )
+      return false;
+    *pc = m_buf[ tail ];
+    m_tail = ( tail + 1 ) & MASK;
+    return true;
+  }
+
+  // consumer, bulk read: head and tail are touched once per call
+  inline size_t Read( T * pDst, size_t nMax )
+  {
+    uint8_t tail = m_tail;
+    uint8_t n    = ( m_head - tail ) & MASK;
+    if( n > nMax )
+      n = nMax;
+    for( uint8_t i = 0; i < n; i++ )
+    {
+      pDst[ i ] = m_buf[ tail ];
+      tail = ( tail + 1 ) & MASK;
+    }
+    m_tail = tail;
+    return n;
+  }
+
+  uint8_t  Available(){ return ( m_head - m_tail ) & MASK; }
+  uint8_t  GetHighWater(){ return m_highWater; } // max. number of buffered elements so far
+  uint16_t GetOverflows()                         // number of dropped elements
+  {
+    uint16_t n;
+    do { n = m_overflows; } while( n != m_overflows ); // 16 bit read is not atomic on AVR, reread if ISR was in between
+    return n;
+  }
+
+protected:
+  enum { MASK = SIZE - 1 };
+
+  volatile T        m_buf[ SIZE ];
+  volatile uint8_t  m_head;
+  volatile uint8_t  m_tail;
+  volatile uint16_t m_overflows;
+  volatile uint8_t  m_highWater;
+};
+
+#endif // RXJETIEXRINGBUF_H
@@ -39,9 +39,290 @@
   // HardwareSerial Serial1(2);
 #endif 
 
+// default bulk read for ports without a buffer of their own
+size_t RxJetiExSerial::Read( uint16_t * pDst, size_t nMax )
+{
+  size_t n = 0;
+  uint16_t c;
+  while( n < nMax && ( c = Getchar() ) != 0 )
+    pDst[ n++ ] = c;
+  return n;
+}
+
+// tag by frame structure: inside an EX or alarm frame all characters are data, in a text only 0xFF is control
+uint16_t RxJetiEx9thBit::Classify( uint8_t c )
+{
+  switch( m_state )
+  {
+  case EX_TYPE:
+    if( ( c & 0x0F ) == 0x0F )
+      m_state = EX_LEN;
+    else if( c & 0x02 ) // alarm: 2 bytes follow
+    {
+      m_nLeft = 2;
+      m_state = EX_DATA;
+    }
+    else
+      m_state = IDLE;
+    return c | 0x100;
+  case EX_LEN:
+    m_nLeft = c & 0x1F;
+    m_state = m_nLeft ? EX_DATA : IDLE;
+    return c | 0x100;
+  case EX_DATA:
+    if( --m_nLeft == 0 )
+      m_state = IDLE;
+    return c | 0x100;
+  case TEXT:
+    if( c == 0xFF || ++m_nLeft > 32 ) // end of text or a lost 0xFF
+      break;
+    return c | 0x100;
+  }
+
+  m_state = IDLE;
+  if( c == 0x7E )
+    m_state = EX_TYPE;
+  else if( c == 0xFE )
+  {
+    m_nLeft = 0;
+    m_state = TEXT;
+  }
+  else if( c != 0xFF )
+    return c | 0x100;
+  return c;
+}
+
+// Host (Linux/POSIX)
+/////////////////////
+#if defined( RXJETIEX_HOST )
+
+  #include <stdlib.h>
+  #include <errno.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <termios.h>
+
+  #if defined (__linux__)
+  #include <sys/epoll.h>
+  #endif
+
+  // port name is taken from environment variable RXJETIEX_PORT, stdin if not set
+  // RXJETIEX_TTY selects a live serial port instead (Linux)
+  RxJetiExSerial * RxJetiExSerial::CreatePort( int /* comPort */ ) // port selected by environment
+  {
+    #if defined (__linux__)
+    if( getenv( "RXJETIEX_TTY" ) )
+      return new RxJetiExTermiosSerial( getenv( "RXJETIEX_TTY" ) );
+    #endif
+    return new RxJetiExPosixSerial( getenv( "RXJETIEX_PORT" ) );
+  }
+
+  RxJetiExPosixSerial::RxJetiExPosixSerial( const char * pPath ) : m_pPath( pPath ), m_fd( -1 ), m_bEof( false ), m_rdIdx( 0 ), m_rdLen( 0 )
+  {
+  }
+
+  RxJetiExPosixSerial::~RxJetiExPosixSerial()
+  {
+    if( m_fd > 0 ) // don't close stdin
+      close( m_fd );
+  }
+
+  void RxJetiExPosixSerial::Init()
+  {
+    m_fd = m_pPath ? open( m_pPath, O_RDONLY | O_NOCTTY | O_NONBLOCK ) : STDIN_FILENO;
+    if( m_fd < 0 )
+    {
+      m_bEof = true;
+      return;
+    }
+
+    // pty: raw mode, the 9 bit words are transported as 16 bit values
+    if( isatty( m_fd ) )
+    {
+      struct termios tio;
+      if( tcgetattr( m_fd, &tio ) == 0 )
+      {
+        cfmakeraw( &tio );
+        tcsetattr( m_fd, TCSANOW, &tio );
+      }
+    }
+  }
+
+  uint16_t RxJetiExPosixSerial::Getchar(void)
+  {
+    if( m_rdLen - m_rdIdx < 2 )
+    {
+      Fill();
+      if( m_rdLen - m_rdIdx < 2 )
+        return 0;
+    }
+
+    uint16_t c = m_rdBuf[ m_rdIdx ] | ( (uint16_t)m_rdBuf[ m_rdIdx + 1 ] << 8 );
+    m_rdIdx += 2;
+    return c & 0x01FF;
+  }
+
+  size_t RxJetiExPosixSerial::Read( uint16_t * pDst, size_t nMax )
+  {
+    if( m_rdLen - m_rdIdx < 2 )
+      Fill();
+
+    size_t n = ( m_rdLen - m_rdIdx ) / 2;
+    if( n > nMax )
+      n = nMax;
+    for( size_t i = 0; i < n; i++, m_rdIdx += 2 )
+      pDst[ i ] = ( m_rdBuf[ m_rdIdx ] | ( (uint16_t)m_rdBuf[ m_rdIdx + 1 ] << 8 ) ) & 0x01FF;
+    return n;
+  }
+
+  // read next chunk, keep an incomplete word at the beginning of the buffer
+  void RxJetiExPosixSerial::Fill()
+  {
+    if( m_fd < 0 || m_bEof )
+      return;
+
+    size_t rest = m_rdLen - m_rdIdx;
+    if( rest )
+      memmove( m_rdBuf, &m_rdBuf[ m_rdIdx ], rest );
+    m_rdIdx = 0;
+    m_rdLen = rest;
+
+    ssize_t n = read( m_fd, &m_rdBuf[ rest ], sizeof( m_rdBuf ) - rest );
+    if( n > 0 )
+      m_rdLen += n;
+    else if( n == 0 && !isatty( m_fd ) )
+      m_bEof = true; // end of file or writer closed the fifo
+    else if( n < 0 && errno != EAGAIN && errno != EINTR )
+      m_bEof = true; // i.e. EIO when the other side of a pty has been closed
+  }
+
+  #if defined (__linux__)
+
+  RxJetiExTermiosSerial::RxJetiExTermiosSerial( const char * pPath, bool bPreMarked ) : m_pPath( pPath ), m_fd( -1 ), m_epfd( -1 ), m_bEof( false ),
+                                                                                         m_bPreMarked( bPreMarked ), m_mark( 0 ), m_rdIdx( 0 ), m_rdLen( 0 )
+  {
+  }
+
+  RxJetiExTermiosSerial::~RxJetiExTermiosSerial()
+  {
+    if( m_epfd >= 0 )
+      close( m_epfd );
+    if( m_fd >= 0 )
+      close( m_fd );
+  }
+
+  void RxJetiExTermiosSerial::Init()
+  {
+    m_fd = m_pPath ? open( m_pPath, O_RDONLY | O_NOCTTY | O_NONBLOCK ) : -1;
+    if( m_fd < 0 )
+    {
+      m_bEof = true;
+      return;
+    }
+
+    // 9600 baud, 8 data bits, mark parity, 2 stop bits, parity errors marked
+    struct termios tio;
+    if( tcgetattr( m_fd, &tio ) == 0 )
+    {
+      cfmakeraw( &tio );
+      tio.c_cflag |= PARENB | PARODD | CMSPAR | CSTOPB | CLOCAL | CREAD;
+      tio.c_iflag |= INPCK | PARMRK;
+      tio.c_iflag &= ~( IGNPAR | ISTRIP );
+      tio.c_cc[ VMIN ]  = 0;
+      tio.c_cc[ VTIME ] = 0;
+      cfsetispeed( &tio, B9600 );
+      cfsetospeed( &tio, B9600 );
+
+      // writer marks control characters itself, the line discipline must not double its 0xFF
+      if( m_bPreMarked )
+        tio.c_iflag &= ~PARMRK;
+
+      tcsetattr( m_fd, TCSANOW, &tio );
+      tcflush( m_fd, TCIFLUSH );
+    }
+
+    m_epfd = epoll_create1( 0 );
+    struct epoll_event ev;
+    memset( &ev, 0, sizeof( ev ) );
+    ev.events  = EPOLLIN;
+    ev.data.fd = m_fd;
+    epoll_ctl( m_epfd, EPOLL_CTL_ADD, m_fd, &ev );
+  }
+
+  bool RxJetiExTermiosSerial::Wait( int timeoutMs )
+  {
+    if( m_rdIdx < m_rdLen )
+      return true;
+    if( m_epfd < 0 || m_bEof )
+      return false;
+    struct epoll_event ev;
+    return epoll_wait( m_epfd, &ev, 1, timeoutMs ) > 0;
+  }
+
+  uint16_t RxJetiExTermiosSerial::Getchar(void)
+  {
+    uint16_t c;
+    return Read( &c, 1 ) ? c : 0;
+  }
+
+  size_t RxJetiExTermiosSerial::Read( uint16_t * pDst, size_t nMax )
+  {
+    size_t n = 0;
+    while( n < nMax )
+    {
+      if( m_rdIdx >= m_rdLen && !Fill() )
+        break;
+
+      uint8_t c = m_rdBuf[ m_rdIdx++ ];
+      switch( m_mark )
+      {
+      case 0:
+        if( c == 0xFF )
+          m_mark = 1;
+        else
+          pDst[ n++ ] = c | 0x100;  // data
+        break;
+      case 1:
+        m_mark = 0;
+        if( c == 0xFF )
+          pDst[ n++ ] = 0x1FF;      // data 0xFF
+        else if( c == 0x00 )
+          m_mark = 2;
+        break;
+      default:
+        m_mark = 0;
+        if( c )
+          pDst[ n++ ] = c;          // parity error: control character, 0 = break or framing error
+        break;
+      }
+    }
+    return n;
+  }
+
+  // nonblocking bulk read, false if nothing available
+  bool RxJetiExTermiosSerial::Fill()
+  {
+    if( m_fd < 0 || m_bEof )
+      return false;
+
+    m_rdIdx = 0;
+    m_rdLen = 0;
+    ssize_t n = read( m_fd, m_rdBuf, sizeof( m_rdBuf ) );
+    if( n > 0 )
+    {
+      m_rdLen = n;
+      return true;
+    }
+    if( n < 0 && errno != EAGAIN && errno != EINTR )
+      m_bEof = true; // i.e. EIO when the adapter is unplugged or the pty master closed
+    return false;
+  }
+
+  #endif // __linux__
+
 // Teensy
 /////////
-#if defined( CORE_TEENSY ) 
+#elif defined( CORE_TEENSY )
 
   RxJetiExSerial * RxJetiExSerial::CreatePort( int comPort )
   {
@@ -72,6 +353,16 @@
     return 0;
   }
 
+  size_t RxJetiExTeensySerial::Read( uint16_t * pDst, size_t nMax )
+  {
+    size_t n = m_pSerial->available();
+    if( n > nMax )
+      n = nMax;
+    for( size_t i = 0; i < n; i++ )
+      pDst[ i ] = m_pSerial->read() & 0xFF;
+    return n;
+  }
+
 #elif defined (RXJETIEX_ARDUINO_UART)
 
   // Arduino HardwareSerial
@@ -83,8 +374,6 @@
 
   RxJetiExArduinoSerial::RxJetiExArduinoSerial( int comPort ) 
   {
-    c_minus1 = c_minus2 = c_minus3 = 0;
-
     switch( comPort )
     {
     default:
@@ -105,7 +394,7 @@
       #endif
       break;
     case 3:
-      #ifdef HAVE_HWSERIAL2
+      #ifdef HAVE_HWSERIAL3
         m_pSerial = &Serial3;
       #endif
       break;
@@ -124,24 +413,19 @@
   uint16_t RxJetiExArduinoSerial::Getchar(void) 
   {                                         
     if( m_pSerial->available() > 0 )
-    {
-      uint16_t c = m_pSerial->read() | 0x100;
-      // 9th bit emulation, check for sequence 0xfe, 0xff, 0x7e --> first ex packet after startup will not be decoded
-      if( (c & 0x00ff) == 0x007e && (c_minus1 & 0x00ff) == 0x00ff && (c_minus2 & 0x00ff) == 0x00fe )
-      {
-        c_minus3 &= ~0x100;
-        c_minus2 &= ~0x100;
-        c_minus1 &= ~0x100;
-        c        &= ~0x100;
-      }
-      c_minus3 = c_minus2;
-      c_minus2 = c_minus1;
-      c_minus1 = c;
-      return c_minus3;
-    }
+      return m_9thBit.Classify( m_pSerial->read() );
     return 0;
   }
 
+  size_t RxJetiExArduinoSerial::Read( uint16_t * pDst, size_t nMax )
+  {
+    size_t n     = 0;
+    int    avail = m_pSerial->available();
+    while( avail-- > 0 && n < nMax )
+      pDst[ n++ ] = m_9thBit.Classify( m_pSerial->read() );
+    return n;
+  }
+
 #else
 
 // ATMega
@@ -149,96 +433,151 @@
 
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+// bits are the same in all USARTs
+#define RXJETIEX_RXB8   1
+#define RXJETIEX_UCSZ2  2
+#define RXJETIEX_TXEN   3
+#define RXJETIEX_RXEN   4
+#define RXJETIEX_TXCIE  6
+#define RXJETIEX_RXCIE  7
+#define RXJETIEX_UCSZ0  1
+#define RXJETIEX_UCSZ1  2
+#define RXJETIEX_UPM0   4
+#define RXJETIEX_UPM1   5
+
+static RxJetiExUsart * GetUsart( uint8_t uart )
+{
+  if( uart >= RXJETIEX_AVR_MAX_UARTS || ( RXJETIEX_AVR_UARTS & ( 1 << uart ) ) == 0 )
+    return NULL;
+
+  switch( uart )
+  {
+  #ifdef UCSR0A
+  case 0: return (RxJetiExUsart *)&UCSR0A;
+  #endif
+  #ifdef UCSR1A
+  case 1: return (RxJetiExUsart *)&UCSR1A;
+  #endif
+  #ifdef UCSR2A
+  case 2: return (RxJetiExUsart *)&UCSR2A;
+  #endif
+  #ifdef UCSR3A
+  case 3: return (RxJetiExUsart *)&UCSR3A;
+  #endif
+  }
+  return NULL;
+}
+
+// Arduino pins of RXDn and TXDn, 0xFF = no USARTn
+static const uint8_t c_usartPins[ RXJETIEX_AVR_MAX_UARTS ][ 2 ] PROGMEM =
+#if defined (__AVR_ATmega2560__) || defined (__AVR_ATmega1280__)
+  { { 0, 1 }, { 19, 18 }, { 17, 16 }, { 15, 14 } };
+#elif defined (__AVR_ATmega32U4__)
+  { { 0xFF, 0xFF }, { 0, 1 }, { 0xFF, 0xFF }, { 0xFF, 0xFF } };
+#elif defined (__AVR_ATmega1284P__) || defined (__AVR_ATmega644P__)
+  { { 8, 9 }, { 10, 11 }, { 0xFF, 0xFF }, { 0xFF, 0xFF } };
+#else
+  { { 0, 1 }, { 0xFF, 0xFF }, { 0xFF, 0xFF }, { 0xFF, 0xFF } };
+#endif
 
 // HARDWARE SERIAL
 //////////////////
+RxJetiExAtMegaSerial::RxJetiExAtMegaSerial( uint8_t uart ) : m_uart( uart ), m_pUsart( GetUsart( uart ) )
+{
+  // default or unavailable: first enabled USART
+  for( uint8_t i = 0; m_pUsart == NULL && i < RXJETIEX_AVR_MAX_UARTS; i++ )
+    if( ( m_pUsart = GetUsart( i ) ) != NULL )
+      m_uart = i;
+}
+
 void RxJetiExAtMegaSerial::Init() // pins are unsued for hardware version
 {
   // init UART-registers
-  UCSRA = 0x00;
-  UCSRB = _BV(UCSZ2) | _BV(RXEN) /* | _BV(TXEN) */;         // 9 Bit, RX enable, Tx disable
-  UCSRC = _BV(UCSZ0) | _BV(UCSZ1) | _BV(UPM0) | _BV(UPM1) ; // 9-bit data, 2 stop bits, odd parity
+  m_pUsart->ucsra = 0x00;
+  m_pUsart->ucsrb = _BV(RXJETIEX_UCSZ2) | _BV(RXJETIEX_RXEN) /* | _BV(TXEN) */;                              // 9 Bit, RX enable, Tx disable
+  m_pUsart->ucsrc = _BV(RXJETIEX_UCSZ0) | _BV(RXJETIEX_UCSZ1) | _BV(RXJETIEX_UPM0) | _BV(RXJETIEX_UPM1) ;   // 9-bit data, 2 stop bits, odd parity
 
   // wormfood.net/avrbaudcalc.php 
 #if F_CPU == 16000000L  // for the 16 MHz clock on most Arduino boards
-  UBRRH = 0x00;
-  UBRRL = 0x66; // 9800 Bit/s
+  m_pUsart->ubrrh = 0x00;
+  m_pUsart->ubrrl = 0x66; // 9800 Bit/s
 #elif F_CPU == 8000000L   // for the 8 MHz internal clock (Pro Mini 3.3 Volt) 
-  UBRRH = 0x00;
-  UBRRL = 0x32; // 9800 Bit/s
+  m_pUsart->ubrrh = 0x00;
+  m_pUsart->ubrrl = 0x32; // 9800 Bit/s
 #else
   #error Unsupported clock speed
 #endif  
 
   // TX and RX pins goes high, when disabled
-  pinMode( 0, INPUT_PULLUP );
-  pinMode( 1, INPUT_PULLUP );
+  for( uint8_t i = 0; i < 2; i++ )
+  {
+    uint8_t pin = pgm_read_byte( &c_usartPins[ m_uart ][ i ] );
+    if( pin != 0xFF )
+      pinMode( pin, INPUT_PULLUP );
+  }
 }
 
 
 // Interrupt driven transmission
 ////////////////////////////////
-RxJetiExHardwareSerialInt * _pInstance = 0;   // instance pointer to find the serial object from ISR
+RxJetiExHardwareSerialInt * RxJetiExHardwareSerialInt::m_pInstances[ RXJETIEX_AVR_MAX_UARTS ];
 
-// static function for port object creation
+// static function for port object creation, comPort n = USARTn, 0 = default
 RxJetiExSerial * RxJetiExSerial::CreatePort( int comPort )
 {
-  return new RxJetiExHardwareSerialInt();
+  return new RxJetiExHardwareSerialInt( comPort ? comPort : 0xFF );
 } 
 
 void RxJetiExHardwareSerialInt::Init()
 {
+  if( m_pUsart == NULL )
+    return; // no USART enabled in RXJETIEX_AVR_UARTS
+
   RxJetiExAtMegaSerial::Init();
 
   // init rx ring buffer 
-  m_rxHeadPtr = m_rxBuf;
-  m_rxTailPtr = m_rxBuf;
-  m_rxNumChar = 0;
+  m_rxBuf.Reset();
 
-  _pInstance  = this; // there is a single instance only
+  m_pInstances[ m_uart ] = this; // one instance per USART
 
   // enable receiver
-  uint8_t ucsrb = UCSRB; 
-  ucsrb        &= ~( (1<<TXEN) | (1<<TXCIE) ); // disable transmitter and tx interrupt when there is nothing more to send
-  ucsrb        |=    (1<<RXEN) | (1<<RXCIE);   // enable receiver with interrupt
-  UCSRB        = ucsrb;
+  uint8_t ucsrb   = m_pUsart->ucsrb; 
+  ucsrb          &= ~( (1<<RXJETIEX_TXEN) | (1<<RXJETIEX_TXCIE) ); // disable transmitter and tx interrupt when there is nothing more to send
+  ucsrb          |=    (1<<RXJETIEX_RXEN) | (1<<RXJETIEX_RXCIE);   // enable receiver with interrupt
+  m_pUsart->ucsrb = ucsrb;
 }
 
 // Read key from Jeti box
 uint16_t RxJetiExHardwareSerialInt::Getchar(void)
 {
   uint16_t c = 0;
-
-  if( m_rxNumChar ) // atomic operation
-  {
-    cli();
-    c = *(_pInstance->m_rxTailPtr);
-    m_rxNumChar--; 
-    m_rxTailPtr = IncBufPtr( m_rxTailPtr, m_rxBuf, RX_RINGBUF_SIZE );
-    sei();
-  }
+  m_rxBuf.Get( &c ); // lock free, ISR only moves the head
   return c;
 }
 
+// ISR trampolines - receiver buffer full, 9th bit must be read before data
+#define RXJETIEX_RX_ISR( vect, uart, ucsrb, udr ) \
+  ISR( vect ) \
+  { \
+    uint16_t bit8 = ( ucsrb & _BV(RXJETIEX_RXB8) ) ? 0x0100 : 0x0000; \
+    RxJetiExHardwareSerialInt::OnReceive( uart, bit8 | udr ); \
+  }
 
-// increment buffer pointer (todo: use templates for 8 and 16 bit versions of pointers)
-volatile uint16_t * RxJetiExHardwareSerialInt::IncBufPtr( volatile uint16_t * ptr, volatile uint16_t * pRingBuf, size_t bufSize )
-{
-  ptr++;
-  if( ptr >= ( pRingBuf + bufSize ) )
-    return pRingBuf; // wrap around
-  else
-    return ptr;
-}
-
-// ISR - receiver buffer full
-ISR( USART_RX_vect )
-{
-  // uint8_t status = UCSR0A;
-  uint16_t bit8 = (UCSRB & _BV(RXB8)) ? 0x0100 : 0x0000;   
-  *(_pInstance->m_rxHeadPtr) = bit8 | UDR;  // write data to buffer
-  _pInstance->m_rxNumChar++;                // increase number of characters in buffer
-  _pInstance->m_rxHeadPtr = _pInstance->IncBufPtr( _pInstance->m_rxHeadPtr, _pInstance->m_rxBuf, _pInstance->RX_RINGBUF_SIZE );    // increase ringbuf pointer
-}
+#if ( RXJETIEX_AVR_UARTS & 0x01 ) && defined( USART_RX_vect )
+  RXJETIEX_RX_ISR( USART_RX_vect, 0, UCSR0B, UDR0 )   // ATmega328P: single USART
+#elif ( RXJETIEX_AVR_UARTS & 0x01 ) && defined( USART0_RX_vect )
+  RXJETIEX_RX_ISR( USART0_RX_vect, 0, UCSR0B, UDR0 )
+#endif
+#if ( RXJETIEX_AVR_UARTS & 0x02 ) && defined( USART1_RX_vect )
+  RXJETIEX_RX_ISR( USART1_RX_vect, 1, UCSR1B, UDR1 )
+#endif
+#if ( RXJETIEX_AVR_UARTS & 0x04 ) && defined( USART2_RX_vect )
+  RXJETIEX_RX_ISR( USART2_RX_vect, 2, UCSR2B, UDR2 )
+#endif
+#if ( RXJETIEX_AVR_UARTS & 0x08 ) && defined( USART3_RX_vect )
+  RXJETIEX_RX_ISR( USART3_RX_vect, 3, UCSR3B, UDR3 )
+#endif
 
 #endif // CORE_TEENSY 
@@ -42,6 +42,12 @@
  #include <WProgram.h>
 #endif
 
+#include "RxJetiExRingBuf.h"
+
+#ifndef RXJETIEX_RX_RINGBUF_SIZE
+  #define RXJETIEX_RX_RINGBUF_SIZE 64 // AVR receive buffer: power of two <= 256, increase if GetOverflows() counts
+#endif
+
 class RxJetiExSerial
 {
 public:
@@ -49,11 +55,99 @@ public:
 
   virtual void     Init() = 0;
   virtual uint16_t Getchar(void) = 0;
+  virtual size_t   Read( uint16_t * pDst, size_t nMax ); // bulk read of up to nMax characters, returns number of characters read
+
+  // receive buffer diagnostics, only available with a ring buffer of our own
+  virtual uint16_t GetOverflows(){ return 0; } // number of dropped characters
+  virtual uint8_t  GetHighWater(){ return 0; } // max. number of buffered characters
 };
 
+// 9th bit reconstruction for 8 bit UARTs
+// follows the frame structure (EX length, alarm, text end) and tags control characters 0x7E, 0xFE, 0xFF
+// as they arrive, no delay line
+class RxJetiEx9thBit
+{
+public:
+  RxJetiEx9thBit() : m_state( IDLE ), m_nLeft( 0 ) {}
+  uint16_t Classify( uint8_t c ); // 9 bit word, bit 8 set for data
+
+protected:
+  enum
+  {
+    IDLE,     // between frames
+    EX_TYPE,  // after 0x7E
+    EX_LEN,
+    EX_DATA,  // m_nLeft data bytes of an EX or alarm frame
+    TEXT,     // after 0xFE until 0xFF
+  };
+  uint8_t m_state;
+  uint8_t m_nLeft;
+};
+
+// Host (Linux/POSIX)
+// reads 9 bit words from a capture file, pipe or pseudo terminal.
+// Stream format: little endian uint16 per word, bit 8 is the 9th (data) bit
+/////////////////////
+#if defined (RXJETIEX_HOST)
+
+  class RxJetiExPosixSerial : public RxJetiExSerial
+  {
+  public:
+    RxJetiExPosixSerial( const char * pPath ); // file, fifo or pty, NULL = stdin
+    ~RxJetiExPosixSerial();
+    virtual void Init();
+    virtual uint16_t Getchar(void);
+    virtual size_t   Read( uint16_t * pDst, size_t nMax );
+
+    bool IsOpen(){ return m_fd >= 0; }
+    bool IsEof(){ return m_bEof; }  // end of capture file reached or pty closed
+  protected:
+    void Fill();
+
+    const char * m_pPath;
+    int          m_fd;
+    bool         m_bEof;
+    uint8_t      m_rdBuf[ 4096 ];
+    size_t       m_rdIdx;
+    size_t       m_rdLen;
+  };
+
+  #if defined (__linux__)
+  // live 9 bit reception with an USB-UART adapter (Linux)
+  // 8 data bits + mark parity: the 9th bit of control characters (0) is a parity error,
+  // marked by the driver as 0xFF 0x00 c (PARMRK), a data 0xFF arrives as 0xFF 0xFF.
+  // A pty has no parity, its writer sends this marked byte stream (bPreMarked).
+  class RxJetiExTermiosSerial : public RxJetiExSerial
+  {
+  public:
+    RxJetiExTermiosSerial( const char * pPath, bool bPreMarked = false ); // i.e. /dev/ttyUSB0, pty slave with bPreMarked
+    ~RxJetiExTermiosSerial();
+    virtual void     Init();
+    virtual uint16_t Getchar(void);
+    virtual size_t   Read( uint16_t * pDst, size_t nMax ); // nonblocking
+
+    bool Wait( int timeoutMs );  // epoll for input, false on timeout
+    int  GetFd(){ return m_fd; } // for an epoll loop of your own
+    bool IsOpen(){ return m_fd >= 0; }
+    bool IsEof(){ return m_bEof; }
+  protected:
+    bool Fill();
+
+    const char * m_pPath;
+    int          m_fd;
+    int          m_epfd;
+    bool         m_bEof;
+    bool         m_bPreMarked;
+    uint8_t      m_mark;   // position in 0xFF 0x00 c sequence
+    uint8_t      m_rdBuf[ 4096 ];
+    size_t       m_rdIdx;
+    size_t       m_rdLen;
+  };
+  #endif
+
 // Teensy
 /////////
-#if defined (CORE_TEENSY) 
+#elif defined (CORE_TEENSY)
 
   class RxJetiExTeensySerial : public RxJetiExSerial
   {
@@ -61,6 +155,7 @@ public:
     RxJetiExTeensySerial( int comPort );
     virtual void Init();
     virtual uint16_t Getchar(void);
+    virtual size_t   Read( uint16_t * pDst, size_t nMax );
   protected:
     HardwareSerial * m_pSerial;
   };
@@ -73,108 +168,73 @@ public:
     RxJetiExArduinoSerial( int comPort );
     virtual void Init();
     virtual uint16_t Getchar(void);
+    virtual size_t   Read( uint16_t * pDst, size_t nMax );
   protected:
     HardwareSerial * m_pSerial;
-    uint16_t c_minus1;
-    uint16_t c_minus2;
-    uint16_t c_minus3;
+    RxJetiEx9thBit   m_9thBit;
   };
 
 #else
 
-  #if defined (__AVR_ATmega32U4__)
-    #define _BV(bit) (1 << (bit))
-    #define UCSRA UCSR1A
-    #define UCSRB UCSR1B
-    #define UCSRC UCSR1C
-
-    #define UCSZ2 UCSZ12
-    #define RXEN RXEN1
-    #define TXEN TXEN1
-    #define UCSZ0 UCSZ10
-    #define UCSZ1 UCSZ11
-    #define UCSZ2 UCSZ12
-
-    #define UPM0 UPM10
-    #define UPM1 UPM11
-
-    #define UBRRH UBRR1H
-    #define UBRRL UBRR1L
-
-    #define RXCIE RXCIE1
-    #define UDRIE UDRIE1
-    #define TXCIE TXCIE1
-
-    #define TXB8 TXB81
-    #define RXB8 RXB81
-
-    #define UDR UDR1
-    #define UDRIE UDRIE1
-
-    #define USART_RX_vect USART1_RX_vect
-    #define USART_TX_vect USART1_TX_vect
-    #define USART_UDRE_vect USART1_UDRE_vect
-  #else
-    #define UCSRA UCSR0A
-    #define UCSRB UCSR0B
-    #define UCSRC UCSR0C
-
-    #define RXEN RXEN0
-    #define TXEN TXEN0
-    #define UCSZ0 UCSZ00
-    #define UCSZ1 UCSZ01
-    #define UCSZ2 UCSZ02
-
-    #define UPM0 UPM00
-    #define UPM1 UPM01
-
-    #define UBRRH UBRR0H
-    #define UBRRL UBRR0L
-
-    #define RXCIE RXCIE0
-    #define UDRIE UDRIE0
-    #define TXCIE TXCIE0
-
-    #define TXB8 TXB80
-    #define RXB8 RXB80
-    #define UDR UDR0
-    #define UDRIE UDRIE0
-  #endif 
+  // ATMega: one interrupt service routine per USART, bit n enables USARTn
+  // i.e. #define RXJETIEX_AVR_UARTS 0x06 for two receivers on Serial1 and Serial2 of an ATmega2560.
+  // The USARTs enabled here can't be used with the Arduino Serial objects.
+  #ifndef RXJETIEX_AVR_UARTS
+    #if defined (__AVR_ATmega32U4__)
+      #define RXJETIEX_AVR_UARTS 0x02 // USART1
+    #else
+      #define RXJETIEX_AVR_UARTS 0x01 // USART0
+    #endif
+  #endif
+  #define RXJETIEX_AVR_MAX_UARTS 4
+
+  // register block of an USART, same layout on all ATmega parts
+  struct RxJetiExUsart
+  {
+    volatile uint8_t ucsra;
+    volatile uint8_t ucsrb;
+    volatile uint8_t ucsrc;
+    volatile uint8_t reserved;
+    volatile uint8_t ubrrl;
+    volatile uint8_t ubrrh;
+    volatile uint8_t udr;
+  };
 
   // ATMega
   //////////
   class RxJetiExAtMegaSerial : public RxJetiExSerial
   {
   public:
+    RxJetiExAtMegaSerial( uint8_t uart ); // USART number, falls back to first enabled USART
     virtual void Init();
+
+  protected:
+    uint8_t         m_uart;
+    RxJetiExUsart * m_pUsart;
   };
 
   // interrupt driven transmission
   // ->  low CPU usage (~1ms per frame), slightly higher latency
   ////////////////////////////////
-
-  extern "C" void USART_RX_vect(void) __attribute__ ((signal)); // make C++ class accessible for ISR
-
   class RxJetiExHardwareSerialInt : public RxJetiExAtMegaSerial
   {
-    friend void USART_RX_vect(void);
-
   public:
+    RxJetiExHardwareSerialInt( uint8_t uart = 0xFF ) : RxJetiExAtMegaSerial( uart ) {}
     virtual void Init();
     virtual uint16_t Getchar(void);
+    virtual size_t   Read( uint16_t * pDst, size_t nMax ){ return m_rxBuf.Read( pDst, nMax ); }
+
+    virtual uint16_t GetOverflows(){ return m_rxBuf.GetOverflows(); }
+    virtual uint8_t  GetHighWater(){ return m_rxBuf.GetHighWater(); }
+
+    // called from USARTn receive interrupt
+    static inline void OnReceive( uint8_t uart, uint16_t c ){ m_pInstances[ uart ]->m_rxBuf.Put( c ); }
 
   protected:
-    enum
-    {
-      RX_RINGBUF_SIZE = 64,
-    };
-
-    // rx buffer
-    volatile uint16_t   m_rxBuf[ RX_RINGBUF_SIZE ]; 
-    volatile uint16_t * m_rxHeadPtr;
-    volatile uint16_t * m_rxTailPtr;
-    volatile uint16_t   m_rxNumChar;
-    volatile uint16_t * IncBufPtr( volatile uint16_t * ptr, volatile uint16_t * ringBuf, size_t bufSize );
+    // rx buffer per instance
+    RxJetiExRingBuf< uint16_t, RXJETIEX_RX_RINGBUF_SIZE > m_rxBuf;
+
+    static RxJetiExHardwareSerialInt * m_pInstances[ RXJETIEX_AVR_MAX_UARTS ]; // ISR trampolines find their port here
   };
   
 #endif // CORE_TEENSY
@@ -0,0 +1,50 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExStream - byte streams for dictionary persistence (EEPROM, flash, file)
+  -------------------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#include "RxJetiExStream.h"
+
+bool RxJetiExMemoryWriter::Write( const uint8_t * pData, size_t nBytes )
+{
+  if( nBytes > m_size - m_pos )
+    return false;
+  memcpy( &m_pBuf[ m_pos ], pData, nBytes );
+  m_pos += nBytes;
+  return true;
+}
+
+bool RxJetiExMemoryReader::Read( uint8_t * pData, size_t nBytes )
+{
+  if( nBytes > m_size - m_pos )
+    return false;
+  memcpy( pData, &m_pBuf[ m_pos ], nBytes );
+  m_pos += nBytes;
+  return true;
+}
@@ -0,0 +1,102 @@
+/* 
+  Jeti EX Telemetry sensor decoder C++ Library
+  
+  RxJetiExStream - byte streams for dictionary persistence (EEPROM, flash, file)
+  -------------------------------------------------------------------------------
+  
+  Copyright (C) 2022 Bernd Wokoeck
+  
+  Version history:
+  0.99   02/09/2022  created
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the "Software"),
+  to deal in the Software without restriction, including without limitation
+  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+  and/or sell copies of the Software, and to permit persons to whom the
+  Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+  OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+  IN THE SOFTWARE.
+
+**************************************************************/
+
+#ifndef RXJETIEXSTREAM_H
+#define RXJETIEXSTREAM_H
+
+#if ARDUINO >= 100
+ #include <Arduino.h>
+#else
+ #include <WProgram.h>
+#endif
+
+// implement for your storage, i.e. EEPROM.update() byte by byte
+class RxJetiExWriter
+{
+public:
+  virtual bool Write( const uint8_t * pData, size_t nBytes ) = 0; // false on error
+};
+
+class RxJetiExReader
+{
+public:
+  virtual bool Read( uint8_t * pData, size_t nBytes ) = 0; // false if not enough data
+};
+
+// RAM buffer
+class RxJetiExMemoryWriter : public RxJetiExWriter
+{
+public:
+  RxJetiExMemoryWriter( uint8_t * pBuf, size_t size ) : m_pBuf( pBuf ), m_size( size ), m_pos( 0 ) {}
+  virtual bool Write( const uint8_t * pData, size_t nBytes );
+  size_t GetSize(){ return m_pos; } // bytes written
+protected:
+  uint8_t * m_pBuf;
+  size_t    m_size;
+  size_t    m_pos;
+};
+
+class RxJetiExMemoryReader : public RxJetiExReader
+{
+public:
+  RxJetiExMemoryReader( const uint8_t * pBuf, size_t size ) : m_pBuf( pBuf ), m_size( size ), m_pos( 0 ) {}
+  virtual bool Read( uint8_t * pData, size_t nBytes );
+protected:
+  const uint8_t * m_pBuf;
+  size_t          m_size;
+  size_t          m_pos;
+};
+
+// Host (Linux/POSIX)
+/////////////////////
+#if defined (RXJETIEX_HOST)
+
+  class RxJetiExFileWriter : public RxJetiExWriter
+  {
+  public:
+    RxJetiExFileWriter( FILE * fp ) : m_fp( fp ) {}
+    virtual bool Write( const uint8_t * pData, size_t nBytes ){ return fwrite( pData, 1, nBytes, m_fp ) == nBytes; }
+  protected:
+    FILE * m_fp;
+  };
+
+  class RxJetiExFileReader : public RxJetiExReader
+  {
+  public:
+    RxJetiExFileReader( FILE * fp ) : m_fp( fp ) {}
+    virtual bool Read( uint8_t * pData, size_t nBytes ){ return fread( pData, 1, nBytes, m_fp ) == nBytes; }
+  protected:
+    FILE * m_fp;
+  };
+
+#endif // RXJETIEX_HOST
+
+#endif // RXJETIEXSTREAM_H